@@ -0,0 +1,172 @@
+// bench.cpp
+// Microbenchmarks for the simulation core hot paths. Each benchmark is
+// warmed up, then run for a fixed number of timed iterations and
+// reported as ns/op; the end-to-end search additionally reports
+// placements/sec. Boards come from a seeded headless game so the
+// numbers reflect realistic mid-game stacks, and runs are comparable
+// across machines and changes.
+//
+// Build: make bench
+// Usage: ./bench [iterations-scale]
+
+#include "tetris_core.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Keep the compiler from optimizing a benchmarked value away.
+template <typename T>
+static inline void doNotOptimize(const T &v) {
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+static double benchNs(const char *name, long long iters,
+                      const std::function<void()> &body) {
+    // Warmup: ~10% of the timed run, at least once.
+    for (long long i = 0; i < iters / 10 + 1; ++i) body();
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iters; ++i) body();
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+    printf("%-34s %12.1f ns/op  (%lld iters)\n", name, ns, iters);
+    return ns;
+}
+
+// Sample boards from a seeded greedy game: realistic stacks of varying
+// height rather than empty or synthetic ones.
+static std::vector<BitBoard> makeCorpus(int count) {
+    std::vector<BitBoard> corpus;
+    Bag bag(20240101);
+    BitBoard bb;
+    int type = bag.next();
+    while ((int)corpus.size() < count) {
+        if (bb.collides(PIECE_TABLE[type][0], 0, BOARD_W/2 - 2)) break;
+        MoveDecision mv = findBestMove(bb, type);
+        if (mv.score < -1e8) break;
+        const PieceMasks &pm = PIECE_TABLE[type][mv.rotationIndex];
+        int top = bb.dropRow(pm, mv.leftC);
+        if (top + pm.minRow < 0) break;
+        bb.place(pm, top, mv.leftC);
+        bb.clearLines();
+        corpus.push_back(bb);
+        type = bag.next();
+    }
+    // Pad by cycling the sampled boards if the game ended early; the
+    // corpus must not be empty.
+    if (corpus.empty()) corpus.push_back(BitBoard());
+    size_t sampled = corpus.size();
+    while ((int)corpus.size() < count)
+        corpus.push_back(corpus[corpus.size() % sampled]);
+    return corpus;
+}
+
+// Board with n full rows at the bottom and a ragged stack above them.
+static BitBoard boardWithFullRows(int n) {
+    BitBoard bb;
+    for (int r = 0; r < BOARD_H; ++r) {
+        if (r >= BOARD_H - n) bb.rows[r] = FULL_ROW;
+        else if (r >= BOARD_H - n - 3) bb.rows[r] = (uint16_t)(0x155 >> (BOARD_H - n - r));
+    }
+    bb.recomputeStats();
+    return bb;
+}
+
+int main(int argc, char **argv) {
+    long long scale = (argc > 1) ? atoll(argv[1]) : 1;
+    if (scale < 1) scale = 1;
+
+    std::vector<BitBoard> corpus = makeCorpus(64);
+    size_t ci = 0;
+    auto nextBoard = [&]() -> const BitBoard & {
+        const BitBoard &b = corpus[ci];
+        ci = (ci + 1) % corpus.size();
+        return b;
+    };
+
+    printf("-- Board primitives --\n");
+
+    benchNs("collides", 10000000 * scale, [&]{
+        const BitBoard &b = nextBoard();
+        bool c = b.collides(PIECE_TABLE[0][0], BOARD_H - 4, 3);
+        doNotOptimize(c);
+    });
+
+    benchNs("dropPosition (iterative)", 1000000 * scale, [&]{
+        const BitBoard &b = nextBoard();
+        int t = b.dropPosition(PIECE_TABLE[5][1], 4);
+        doNotOptimize(t);
+    });
+
+    benchNs("dropRow (height table)", 10000000 * scale, [&]{
+        const BitBoard &b = nextBoard();
+        int t = b.dropRow(PIECE_TABLE[5][1], 4);
+        doNotOptimize(t);
+    });
+
+    {
+        BitBoard b0 = boardWithFullRows(0);
+        BitBoard b1 = boardWithFullRows(1);
+        BitBoard b4 = boardWithFullRows(4);
+        benchNs("clearLines (0 full rows)", 1000000 * scale, [&]{
+            BitBoard b = b0;
+            int c = b.clearLines();
+            doNotOptimize(c);
+        });
+        benchNs("clearLines (1 full row)", 1000000 * scale, [&]{
+            BitBoard b = b1;
+            int c = b.clearLines();
+            doNotOptimize(c);
+        });
+        benchNs("clearLines (4 full rows)", 1000000 * scale, [&]{
+            BitBoard b = b4;
+            int c = b.clearLines();
+            doNotOptimize(c);
+        });
+    }
+
+    printf("-- Heuristic features --\n");
+
+    benchNs("holes (cached)", 10000000 * scale, [&]{
+        int h = nextBoard().holes();
+        doNotOptimize(h);
+    });
+
+    benchNs("aggregateHeight (cached)", 10000000 * scale, [&]{
+        int a = nextBoard().aggregateHeight();
+        doNotOptimize(a);
+    });
+
+    benchNs("bumpiness", 10000000 * scale, [&]{
+        int b = nextBoard().bumpiness();
+        doNotOptimize(b);
+    });
+
+    benchNs("recomputeStats (full rescan)", 1000000 * scale, [&]{
+        BitBoard b = nextBoard();
+        b.recomputeStats();
+        doNotOptimize(b.holeCnt);
+    });
+
+    printf("-- End-to-end search --\n");
+
+    {
+        long long iters = 100000 * scale;
+        double ns = benchNs("findBestMove (greedy)", iters, [&]{
+            MoveDecision mv = findBestMove(nextBoard(), 5);
+            doNotOptimize(mv.score);
+        });
+        printf("%-34s %12.0f placements/sec\n", "", 1e9 / ns);
+    }
+
+    {
+        long long iters = 10000 * scale;
+        double ns = benchNs("findBestMoveLookahead (2-ply)", iters, [&]{
+            MoveDecision mv = findBestMoveLookahead(nextBoard(), 5, 2);
+            doNotOptimize(mv.score);
+        });
+        printf("%-34s %12.0f placements/sec\n", "", 1e9 / ns);
+    }
+
+    return 0;
+}
@@ -1,6 +1,8 @@
-// tetris_raylib.cpp
-// Single-file Tetris-like game using raylib (C++).
-// Features: Main menu, 10x20 board, 7-bag randomizer, rotation, collision, line clear, next-piece preview, scoring, level speed.
+// exp.cpp
+// Single-file manual Tetris using raylib (C++), with a main menu and an
+// instructions screen. Board, tetromino data and bag randomizer come
+// from the shared simulation core (tetris_core.h, linked from
+// libtetris.a); this file keeps the menus, input handling and drawing.
 // Controls:
 //  - Left / Right arrows: move piece
 //  - Down arrow: soft drop
@@ -9,23 +11,17 @@
 //  - Space: hard drop
 //  - P: pause
 // Build (Linux):
-//   g++ tetris_raylib.cpp -o tetris -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
-// Build (Windows - MSYS2):
-//   g++ tetris_raylib.cpp -o tetris.exe -lraylib -lopengl32 -lgdi32 -lwinmm
+//   make exp
 
 #include <raylib.h>
+#include "tetris_core.h"
 #include <vector>
 #include <array>
-#include <algorithm>
-#include <random>
-#include <chrono>
 #include <string>
+#include <cmath>
 
 using namespace std;
 
-// Board dimensions
-const int BOARD_W = 10;
-const int BOARD_H = 20;
 const int CELL = 24;
 const int WINDOW_W = 640;
 const int WINDOW_H = 720;
@@ -37,45 +33,7 @@ enum GameState {
     GAME_OVER
 };
 
-// Tetromino definitions (4x4 matrices)
-static const array<array<int,16>,7> TETROMINO = {
-    // I
-    array<int,16>{0,0,0,0,
-                  1,1,1,1,
-                  0,0,0,0,
-                  0,0,0,0},
-    // O
-    array<int,16>{0,1,1,0,
-                  0,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // T
-    array<int,16>{0,1,0,0,
-                  1,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // J
-    array<int,16>{1,0,0,0,
-                  1,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // L
-    array<int,16>{0,0,1,0,
-                  1,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // S
-    array<int,16>{0,1,1,0,
-                  1,1,0,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // Z
-    array<int,16>{1,1,0,0,
-                  0,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0}
-};
-
+// Board cells hold TETROMINO_COLOR ids, which index this palette.
 static const array<Color,8> PALETTE = {
     BLACK, SKYBLUE, YELLOW, MAGENTA, BLUE, ORANGE, GREEN, RED
 };
@@ -86,38 +44,22 @@ struct Piece {
     int rotation; // 0..3
 };
 
-// Board: 0 empty, 1..7 filled with tetromino id +1
 struct Game {
-    array<array<int, BOARD_W>, BOARD_H> board{};
+    Board board;
     Piece cur;
-    vector<int> bag; // upcoming queue
+    Bag bag;
     int score = 0;
     int lines = 0;
     int level = 1;
     bool gameOver = false;
     bool paused = false;
-    std::mt19937 rng;
-    
+
     Game(){
-        rng.seed((unsigned)chrono::high_resolution_clock::now().time_since_epoch().count());
-        refillBag();
         spawnPiece();
     }
 
-    void refillBag(){
-        bag.clear();
-        for(int i=0;i<7;i++) bag.push_back(i);
-        shuffle(bag.begin(), bag.end(), rng);
-    }
-
-    int nextFromBag(){
-        if(bag.empty()) refillBag();
-        int v = bag.back(); bag.pop_back();
-        return v;
-    }
-
     void spawnPiece(){
-        cur.type = nextFromBag();
+        cur.type = bag.next();
         cur.rotation = 0;
         cur.x = (BOARD_W/2) - 2;
         cur.y = 0;
@@ -126,60 +68,23 @@ struct Game {
         }
     }
 
-    int pieceCell(int type, int rotation, int i, int j) const {
-        int idx = 0;
-        switch(rotation % 4){
-            case 0: idx = i*4 + j; break;
-            case 1: idx = (3 - j)*4 + i; break;
-            case 2: idx = (3 - i)*4 + (3 - j); break;
-            case 3: idx = j*4 + (3 - i); break;
-        }
-        return TETROMINO[type][idx];
-    }
-
+    // Core collision plus the rule this game has always had: cells above
+    // the top row collide, so a piece never leaves the visible field.
     bool collides(int px, int py, int type, int rotation) const {
-        for(int i=0;i<4;i++){
-            for(int j=0;j<4;j++){
-                if(pieceCell(type, rotation, i, j)){
-                    int bx = px + j;
-                    int by = py + i;
-                    if(bx < 0 || bx >= BOARD_W || by < 0 || by >= BOARD_H) return true;
-                    if(board[by][bx] != 0) return true;
-                }
-            }
-        }
-        return false;
+        int rot = rotation & 3;
+        if(py + PIECE_TABLE[type][rot].minRow < 0) return true;
+        return board.collides(TETROMINO_STATES[type][rot], py, px);
     }
 
     void lockPiece(){
-        for(int i=0;i<4;i++){
-            for(int j=0;j<4;j++){
-                if(pieceCell(cur.type, cur.rotation, i, j)){
-                    int bx = cur.x + j;
-                    int by = cur.y + i;
-                    if(by >= 0 && by < BOARD_H && bx >=0 && bx < BOARD_W)
-                        board[by][bx] = cur.type + 1;
-                }
-            }
-        }
+        board.placePiece(TETROMINO_STATES[cur.type][cur.rotation & 3],
+                         cur.y, cur.x, TETROMINO_COLOR[cur.type]);
         clearLines();
         spawnPiece();
     }
 
     void clearLines(){
-        int cleared = 0;
-        for(int r = BOARD_H - 1; r >= 0; r--){
-            bool full = true;
-            for(int c=0;c<BOARD_W;c++) if(board[r][c] == 0){ full = false; break; }
-            if(full){
-                cleared++;
-                for(int rr = r; rr > 0; rr--){
-                    board[rr] = board[rr-1];
-                }
-                board[0].fill(0);
-                r++;
-            }
-        }
+        int cleared = board.clearLines();
         if(cleared > 0){
             lines += cleared;
             static const int pointsPer[5] = {0,40,100,300,1200};
@@ -202,60 +107,60 @@ struct MenuItem {
 
 void DrawMainMenu(int& selectedOption, float animTime) {
     ClearBackground(Color{20, 20, 40, 255});
-    
+
     // Title with animation
     const char* title = "TETRIS";
     int titleSize = 80;
     int titleWidth = MeasureText(title, titleSize);
     int titleY = 120 + (int)(sin(animTime * 2) * 5);
-    
+
     // Shadow
     DrawText(title, WINDOW_W/2 - titleWidth/2 + 4, titleY + 4, titleSize, Fade(BLACK, 0.5f));
     // Main title with gradient effect (simulated with multiple draws)
     DrawText(title, WINDOW_W/2 - titleWidth/2, titleY, titleSize, SKYBLUE);
-    
+
     // Falling block animation in background
     for(int i = 0; i < 7; i++) {
         int xPos = 50 + i * 85;
         int yPos = (int)(100 + fmod(animTime * 80 + i * 60, WINDOW_H + 100)) % (WINDOW_H + 100) - 50;
         DrawRectangle(xPos, yPos, 30, 30, Fade(PALETTE[i+1], 0.3f));
     }
-    
+
     // Menu options
     vector<string> options = {"Start Game", "Instructions", "Quit"};
     int startY = 320;
     int spacing = 80;
-    
+
     for(size_t i = 0; i < options.size(); i++) {
         int optionY = startY + i * spacing;
         int textWidth = MeasureText(options[i].c_str(), 30);
         int textX = WINDOW_W/2 - textWidth/2;
-        
+
         bool isSelected = (selectedOption == (int)i);
         Color textColor = isSelected ? YELLOW : WHITE;
-        
+
         // Selected highlight
         if(isSelected) {
             DrawRectangle(textX - 20, optionY - 10, textWidth + 40, 50, Fade(SKYBLUE, 0.3f));
             DrawText(">", textX - 50, optionY, 30, YELLOW);
         }
-        
+
         DrawText(options[i].c_str(), textX, optionY, 30, textColor);
     }
-    
+
     // Footer
-    DrawText("Use UP/DOWN arrows and ENTER to select", WINDOW_W/2 - MeasureText("Use UP/DOWN arrows and ENTER to select", 16)/2, 
+    DrawText("Use UP/DOWN arrows and ENTER to select", WINDOW_W/2 - MeasureText("Use UP/DOWN arrows and ENTER to select", 16)/2,
              WINDOW_H - 80, 16, LIGHTGRAY);
 }
 
 void DrawInstructions(bool& showInstructions) {
     ClearBackground(Color{20, 20, 40, 255});
-    
+
     DrawText("INSTRUCTIONS", WINDOW_W/2 - MeasureText("INSTRUCTIONS", 40)/2, 60, 40, SKYBLUE);
-    
+
     int startY = 140;
     int lineHeight = 35;
-    
+
     vector<pair<string, string>> instructions = {
         {"LEFT/RIGHT", "Move piece"},
         {"DOWN", "Soft drop"},
@@ -265,22 +170,22 @@ void DrawInstructions(bool& showInstructions) {
         {"P", "Pause game"},
         {"ENTER/R", "Restart (Game Over)"}
     };
-    
+
     for(size_t i = 0; i < instructions.size(); i++) {
         int y = startY + i * lineHeight;
         DrawText(instructions[i].first.c_str(), 120, y, 20, YELLOW);
         DrawText("-", 280, y, 20, WHITE);
         DrawText(instructions[i].second.c_str(), 310, y, 20, WHITE);
     }
-    
+
     // Game info
     DrawText("OBJECTIVE:", 120, startY + 280, 24, SKYBLUE);
     DrawText("Clear lines by filling rows completely.", 120, startY + 315, 18, LIGHTGRAY);
     DrawText("Game speeds up every 10 lines.", 120, startY + 345, 18, LIGHTGRAY);
     DrawText("Don't let blocks reach the top!", 120, startY + 375, 18, LIGHTGRAY);
-    
+
     // Back instruction
-    DrawText("Press ENTER to return to menu", WINDOW_W/2 - MeasureText("Press ENTER to return to menu", 18)/2, 
+    DrawText("Press ENTER to return to menu", WINDOW_W/2 - MeasureText("Press ENTER to return to menu", 18)/2,
              WINDOW_H - 60, 18, YELLOW);
 }
 
@@ -302,7 +207,7 @@ int main(){
 
     while(!WindowShouldClose()){
         animTime += GetFrameTime();
-        
+
         // Main Menu State
         if(gameState == MAIN_MENU) {
             if(!showInstructions) {
@@ -333,7 +238,7 @@ int main(){
                     showInstructions = false;
                 }
             }
-            
+
             BeginDrawing();
             if(showInstructions) {
                 DrawInstructions(showInstructions);
@@ -346,11 +251,11 @@ int main(){
 
         // Playing State
         if(IsKeyPressed(KEY_P)) game.paused = !game.paused;
-        
+
         if(game.gameOver){
             if(IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_R)){
                 game = Game();
-                gravityTimer = 0; 
+                gravityTimer = 0;
                 inputTimer = 0;
             }
             if(IsKeyPressed(KEY_ESCAPE)) {
@@ -436,7 +341,7 @@ int main(){
 
         for(int r=0;r<BOARD_H;r++){
             for(int c=0;c<BOARD_W;c++){
-                int v = game.board[r][c];
+                int v = game.board.cells[r][c];
                 if(v){
                     DrawRectangle(boardX + c*CELL, boardY + r*CELL, CELL-2, CELL-2, PALETTE[v]);
                 }
@@ -444,13 +349,14 @@ int main(){
         }
 
         if(!game.gameOver){
+            const Matrix4 &shape = TETROMINO_STATES[game.cur.type][game.cur.rotation & 3];
             for(int i=0;i<4;i++){
                 for(int j=0;j<4;j++){
-                    if(game.pieceCell(game.cur.type, game.cur.rotation, i, j)){
+                    if(shape[i][j]){
                         int bx = game.cur.x + j;
                         int by = game.cur.y + i;
                         if(by >= 0){
-                            DrawRectangle(boardX + bx*CELL, boardY + by*CELL, CELL-2, CELL-2, PALETTE[game.cur.type+1]);
+                            DrawRectangle(boardX + bx*CELL, boardY + by*CELL, CELL-2, CELL-2, PALETTE[TETROMINO_COLOR[game.cur.type]]);
                         }
                     }
                 }
@@ -468,24 +374,16 @@ int main(){
 
         DrawText("Next:", sidebarX, sidebarY + 90, 18, BLACK);
         int nx = sidebarX; int ny = sidebarY + 120;
-        
-        vector<int> preview;
-        auto tmpBag = game.bag;
-        std::mt19937 tmpRng = game.rng;
-        while(preview.size() < 5){
-            if(tmpBag.empty()){
-                array<int,7> seeds = {0,1,2,3,4,5,6};
-                std::shuffle(seeds.begin(), seeds.end(), tmpRng);
-                for(int k=0;k<7;k++) tmpBag.push_back(seeds[k]);
-            }
-            preview.push_back(tmpBag.back()); tmpBag.pop_back();
-        }
-        for(size_t pi=0; pi<preview.size(); pi++){
-            int t = preview[pi];
+
+        // Next 5 pieces; Bag::peek draws future bags early without
+        // changing the sequence next() will produce.
+        for(int pi = 0; pi < 5; pi++){
+            int t = game.bag.peek(pi);
+            const Matrix4 &shape = TETROMINO_STATES[t][0];
             for(int i=0;i<4;i++){
                 for(int j=0;j<4;j++){
-                    if(game.pieceCell(t,0,i,j)){
-                        DrawRectangle(nx + j*12 + 40, ny + i*12 + pi*60, 10, 10, PALETTE[t+1]);
+                    if(shape[i][j]){
+                        DrawRectangle(nx + j*12 + 40, ny + i*12 + pi*60, 10, 10, PALETTE[TETROMINO_COLOR[t]]);
                     }
                 }
             }
@@ -513,4 +411,4 @@ int main(){
 
     CloseWindow();
     return 0;
-}
\ No newline at end of file
+}
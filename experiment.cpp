@@ -1,6 +1,8 @@
-// tetris_raylib.cpp
-// Single-file Tetris-like game using raylib (C++).
-// Features: 10x20 board, 7-bag randomizer, rotation, collision, line clear, next-piece preview, scoring, level speed.
+// experiment.cpp
+// Single-file manual Tetris using raylib (C++), the minimal variant
+// without menus. Board, tetromino data and bag randomizer come from the
+// shared simulation core (tetris_core.h, linked from libtetris.a); this
+// file keeps the input handling and drawing.
 // Controls:
 //  - Left / Right arrows: move piece
 //  - Down arrow: soft drop
@@ -9,85 +11,20 @@
 //  - Space: hard drop
 //  - P: pause
 // Build (Linux):
-//   g++ tetris_raylib.cpp -o tetris -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
-// Build (Windows - MSYS2):
-//   g++ tetris_raylib.cpp -o tetris.exe -lraylib -lopengl32 -lgdi32 -lwinmm
+//   make experiment
 
 #include <raylib.h>
-#include <vector>
+#include "tetris_core.h"
 #include <array>
-#include <algorithm>
-#include <random>
-#include <chrono>
 #include <string>
 
 using namespace std;
 
-// Board dimensions
-const int BOARD_W = 10;
-const int BOARD_H = 20;
 const int CELL = 24;
 const int WINDOW_W = 640;
 const int WINDOW_H = 720;
 
-// Tetromino definitions (4x4 matrices encoded as 16 chars)
-// We'll use 7 standard tetrominoes: I O T J L S Z
-static const array<string, 7> TETROMINO_RAW = {
-    // I
-    string("..X...X...X...X."),
-    // O
-    string(".... .XX. .XX. ...."), // we'll normalize eliminate spaces
-    // T
-    string(".... .XXX ..X. ...."),
-    // J
-    string("..X. ..X. .XX. ...."),
-    // L
-    string("...X ...X .XX. ...."),
-    // S
-    string(".... .XX. .XX. ...."),
-    // Z
-    string(".... .XX. .XX. ....")
-};
-
-// Instead of the above mixed strings we'll define clear 4x4 manually per shape (0/1)
-static const array<array<int,16>,7> TETROMINO = {
-    // I
-    array<int,16>{0,0,0,0,
-                  1,1,1,1,
-                  0,0,0,0,
-                  0,0,0,0},
-    // O
-    array<int,16>{0,1,1,0,
-                  0,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // T
-    array<int,16>{0,1,0,0,
-                  1,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // J
-    array<int,16>{1,0,0,0,
-                  1,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // L
-    array<int,16>{0,0,1,0,
-                  1,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // S
-    array<int,16>{0,1,1,0,
-                  1,1,0,0,
-                  0,0,0,0,
-                  0,0,0,0},
-    // Z
-    array<int,16>{1,1,0,0,
-                  0,1,1,0,
-                  0,0,0,0,
-                  0,0,0,0}
-};
-
+// Board cells hold TETROMINO_COLOR ids, which index this palette.
 static const array<Color,8> PALETTE = {
     BLACK, SKYBLUE, YELLOW, MAGENTA, BLUE, ORANGE, GREEN, RED
 };
@@ -98,37 +35,22 @@ struct Piece {
     int rotation; // 0..3
 };
 
-// Board: 0 empty, 1..7 filled with tetromino id +1
 struct Game {
-    array<array<int, BOARD_W>, BOARD_H> board{};
+    Board board;
     Piece cur;
-    vector<int> bag; // upcoming queue
+    Bag bag;
     int score = 0;
     int lines = 0;
     int level = 1;
     bool gameOver = false;
     bool paused = false;
-    std::mt19937 rng;
+
     Game(){
-        rng.seed((unsigned)chrono::high_resolution_clock::now().time_since_epoch().count());
-        refillBag();
         spawnPiece();
     }
 
-    void refillBag(){
-        bag.clear();
-        for(int i=0;i<7;i++) bag.push_back(i);
-        shuffle(bag.begin(), bag.end(), rng);
-    }
-
-    int nextFromBag(){
-        if(bag.empty()) refillBag();
-        int v = bag.back(); bag.pop_back();
-        return v;
-    }
-
     void spawnPiece(){
-        cur.type = nextFromBag();
+        cur.type = bag.next();
         cur.rotation = 0;
         cur.x = (BOARD_W/2) - 2;
         cur.y = 0;
@@ -137,63 +59,23 @@ struct Game {
         }
     }
 
-    // returns value at 4x4 for piece type, rotation, i,j
-    int pieceCell(int type, int rotation, int i, int j) const {
-        // i row 0..3, j col 0..3
-        int idx = 0;
-        switch(rotation % 4){
-            case 0: idx = i*4 + j; break;
-            case 1: idx = (3 - j)*4 + i; break; // rotate 90
-            case 2: idx = (3 - i)*4 + (3 - j); break; // 180
-            case 3: idx = j*4 + (3 - i); break; // 270
-        }
-        return TETROMINO[type][idx];
-    }
-
+    // Core collision plus the rule this game has always had: cells above
+    // the top row collide, so a piece never leaves the visible field.
     bool collides(int px, int py, int type, int rotation) const {
-        for(int i=0;i<4;i++){
-            for(int j=0;j<4;j++){
-                if(pieceCell(type, rotation, i, j)){
-                    int bx = px + j;
-                    int by = py + i;
-                    if(bx < 0 || bx >= BOARD_W || by < 0 || by >= BOARD_H) return true;
-                    if(board[by][bx] != 0) return true;
-                }
-            }
-        }
-        return false;
+        int rot = rotation & 3;
+        if(py + PIECE_TABLE[type][rot].minRow < 0) return true;
+        return board.collides(TETROMINO_STATES[type][rot], py, px);
     }
 
     void lockPiece(){
-        for(int i=0;i<4;i++){
-            for(int j=0;j<4;j++){
-                if(pieceCell(cur.type, cur.rotation, i, j)){
-                    int bx = cur.x + j;
-                    int by = cur.y + i;
-                    if(by >= 0 && by < BOARD_H && bx >=0 && bx < BOARD_W)
-                        board[by][bx] = cur.type + 1;
-                }
-            }
-        }
+        board.placePiece(TETROMINO_STATES[cur.type][cur.rotation & 3],
+                         cur.y, cur.x, TETROMINO_COLOR[cur.type]);
         clearLines();
         spawnPiece();
     }
 
     void clearLines(){
-        int cleared = 0;
-        for(int r = BOARD_H - 1; r >= 0; r--){
-            bool full = true;
-            for(int c=0;c<BOARD_W;c++) if(board[r][c] == 0){ full = false; break; }
-            if(full){
-                cleared++;
-                // move everything above down
-                for(int rr = r; rr > 0; rr--){
-                    board[rr] = board[rr-1];
-                }
-                board[0].fill(0);
-                r++; // recheck same row index since rows shifted
-            }
-        }
+        int cleared = board.clearLines();
         if(cleared > 0){
             lines += cleared;
             // scoring (classic-ish)
@@ -318,7 +200,7 @@ int main(){
         // Draw placed blocks
         for(int r=0;r<BOARD_H;r++){
             for(int c=0;c<BOARD_W;c++){
-                int v = game.board[r][c];
+                int v = game.board.cells[r][c];
                 if(v){
                     DrawRectangle(boardX + c*CELL, boardY + r*CELL, CELL-2, CELL-2, PALETTE[v]);
                 }
@@ -327,13 +209,14 @@ int main(){
 
         // Draw current piece
         if(!game.gameOver){
+            const Matrix4 &shape = TETROMINO_STATES[game.cur.type][game.cur.rotation & 3];
             for(int i=0;i<4;i++){
                 for(int j=0;j<4;j++){
-                    if(game.pieceCell(game.cur.type, game.cur.rotation, i, j)){
+                    if(shape[i][j]){
                         int bx = game.cur.x + j;
                         int by = game.cur.y + i;
                         if(by >= 0){
-                            DrawRectangle(boardX + bx*CELL, boardY + by*CELL, CELL-2, CELL-2, PALETTE[game.cur.type+1]);
+                            DrawRectangle(boardX + bx*CELL, boardY + by*CELL, CELL-2, CELL-2, PALETTE[TETROMINO_COLOR[game.cur.type]]);
                         }
                     }
                 }
@@ -353,28 +236,15 @@ int main(){
 
         DrawText("Next:", sidebarX, sidebarY + 90, 18, BLACK);
         int nx = sidebarX; int ny = sidebarY + 120;
-        // Show next 5 (peek into bag + random)
-        // We'll simulate by copying bag state but not modifying game.bag permanently
-        vector<int> preview;
-        // take current bag content reversed plus random refill sample if needed
-        // simple approach: reproduce bag vector in order of popping: last element is next
-        // we copy and if needed refill with a shuffled bag
-        auto tmpBag = game.bag;
-        std::mt19937 tmpRng = game.rng;
-        while(preview.size() < 5){
-            if(tmpBag.empty()){
-                array<int,7> seeds = {0,1,2,3,4,5,6};
-                std::shuffle(seeds.begin(), seeds.end(), tmpRng);
-                for(int k=0;k<7;k++) tmpBag.push_back(seeds[k]);
-            }
-            preview.push_back(tmpBag.back()); tmpBag.pop_back();
-        }
-        for(size_t pi=0; pi<preview.size(); pi++){
-            int t = preview[pi];
+        // Show next 5; Bag::peek draws future bags early without
+        // changing the sequence next() will produce.
+        for(int pi = 0; pi < 5; pi++){
+            int t = game.bag.peek(pi);
+            const Matrix4 &shape = TETROMINO_STATES[t][0];
             for(int i=0;i<4;i++){
                 for(int j=0;j<4;j++){
-                    if(game.pieceCell(t,0,i,j)){
-                        DrawRectangle(nx + j*12 + 40, ny + i*12 + pi*60, 10, 10, PALETTE[t+1]);
+                    if(shape[i][j]){
+                        DrawRectangle(nx + j*12 + 40, ny + i*12 + pi*60, 10, 10, PALETTE[TETROMINO_COLOR[t]]);
                     }
                 }
             }
@@ -0,0 +1,355 @@
+// tetris_core.cpp
+// Out-of-line part of the simulation core: the AI searches and the
+// headless game loop. These are the functions where the cycles go, so
+// they are compiled exactly once into libtetris.a — one translation
+// unit for the profiler to train on and for LTO to optimize against
+// every binary (see the `pgo` target in the Makefile). The small hot
+// BitBoard methods and the constexpr tables stay in tetris_core.h so
+// they inline into these bodies and into any caller.
+
+#include "tetris_core.h"
+
+// Shared pool for AI searches; created on first use and kept for the
+// lifetime of the process.
+ThreadPool &aiThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+EvalCache &evalCache() {
+    static thread_local EvalCache cache;
+    return cache;
+}
+
+// ==================== CANDIDATE BATCH ====================
+// The greedy search runs as a three-stage pipeline over a structure-of-
+// arrays batch instead of interleaving simulation and scalar scoring per
+// candidate: enumerate every legal (rotation, column) placement into
+// per-feature arrays, score the whole batch as one dot product against
+// the weight vector (independent lanes, so the loop is free to
+// vectorize), then reduce to the argmax. Scoring is pure int32-weight x
+// int32-feature products accumulated in int64 (see FixedWeights), so
+// comparisons are exact and the chosen move is identical on every
+// platform; enumeration order still decides ties like the old loop.
+//
+// The batch layout also gives pruning a home: lines, holes and aggregate
+// height fall straight out of the incremental move stats, so a candidate
+// whose partial score already cannot beat the best exact score seen so
+// far skips the bumpiness scan (sound whenever w.bumpy <= 0, which every
+// shipped weight set satisfies; a pruned candidate's true score can only
+// be lower still). The batch is also the unit of work the lookahead
+// search hands to the pool: each worker runs one inner batch.
+
+namespace {
+
+// At most 4 rotations x W columns per piece; the batch is sized for its
+// board width so wider research boards get proportionally more lanes.
+template <int W>
+struct CandBatch {
+    static constexpr int MAX = 4 * W;
+    int n = 0;
+    int8_t rot[MAX];
+    int8_t left[MAX];
+    int32_t lines[MAX];
+    int32_t holes[MAX];
+    int32_t aggH[MAX];
+    int32_t bumpy[MAX];
+    bool pruned[MAX];
+};
+
+// Stage 1: simulate every legal placement on one in-place working copy
+// (apply + undo, no board copies) and collect its feature vector.
+template <int W, int H>
+void enumerateCandidates(const BitBoardT<W,H> &bb, int pieceType, const FixedWeights &fw,
+                         CandBatch<W> &batch) {
+    const std::array<PieceMasks,4> &states = PIECE_TABLE[pieceType];
+    BitBoardT<W,H> b2 = bb;
+    typename BitBoardT<W,H>::MoveUndo undo;
+    const bool canPrune = fw.bumpy <= 0;
+    int64_t runningBest = INT64_MIN;
+
+    for (int rIdx = 0; rIdx < PIECE_ROTATIONS[pieceType]; ++rIdx) {
+        const PieceMasks &pm = states[rIdx];
+        for (int left = -pm.minCol; left + pm.maxCol < W; ++left) {
+            int top = b2.dropRow(pm, left);
+            int ln = b2.applyMove(pm, top, left, undo);
+
+            int i = batch.n++;
+            batch.rot[i] = (int8_t)rIdx;
+            batch.left[i] = (int8_t)left;
+            batch.lines[i] = ln;
+            batch.holes[i] = b2.holes();
+            batch.aggH[i] = b2.aggregateHeight();
+
+            int64_t partial = (int64_t)fw.lines * ln
+                            + (int64_t)fw.hole * batch.holes[i]
+                            + (int64_t)fw.height * batch.aggH[i];
+            if (canPrune && partial <= runningBest) {
+                // Cannot beat an exact score already seen; skip the one
+                // feature the incremental stats don't carry.
+                batch.bumpy[i] = 0;
+                batch.pruned[i] = true;
+            } else {
+                batch.bumpy[i] = b2.bumpiness();
+                batch.pruned[i] = false;
+                int64_t exact = partial + (int64_t)fw.bumpy * batch.bumpy[i];
+                if (exact > runningBest) runningBest = exact;
+            }
+
+            b2.undoMove(undo);
+        }
+    }
+}
+
+} // namespace
+
+template <int W, int H>
+MoveDecision findBestMove(const BitBoardT<W,H> &bb, int pieceType, const Weights &w) {
+    const FixedWeights fw = toFixed(w);
+    CandBatch<W> batch;
+    enumerateCandidates(bb, pieceType, fw, batch);
+
+    // Stage 2: integer dot product across the whole batch. Kept
+    // branch-free so the compiler can vectorize; pruned lanes are masked
+    // out after (the first candidate is never pruned, so the mask can
+    // never empty the batch).
+    int64_t scores[CandBatch<W>::MAX];
+    for (int i = 0; i < batch.n; ++i)
+        scores[i] = (int64_t)fw.lines * batch.lines[i]
+                  + (int64_t)fw.hole * batch.holes[i]
+                  + (int64_t)fw.height * batch.aggH[i]
+                  + (int64_t)fw.bumpy * batch.bumpy[i];
+    for (int i = 0; i < batch.n; ++i)
+        if (batch.pruned[i]) scores[i] = INT64_MIN;
+
+    // Stage 3: argmax in enumeration order (strict >, so ties keep the
+    // earliest candidate).
+    int bestIdx = -1;
+    int64_t bestScore = INT64_MIN;
+    for (int i = 0; i < batch.n; ++i) {
+        if (scores[i] > bestScore) {
+            bestScore = scores[i];
+            bestIdx = i;
+        }
+    }
+    if (bestIdx < 0) return {0, 0, -1e9, 0};
+    return {batch.rot[bestIdx], batch.left[bestIdx],
+            (double)bestScore / FIXED_SCALE, batch.lines[bestIdx]};
+}
+
+template <int W, int H>
+MoveDecision findBestMove(const BoardT<W,H> &board, int pieceType) {
+    return findBestMove(BitBoardT<W,H>(board), pieceType);
+}
+
+template <int W, int H>
+MoveDecision findBestMoveLookahead(const BitBoardT<W,H> &bb, int curType, int nextType,
+                                   ThreadPool *pool, const Weights &w) {
+    const std::array<PieceMasks,4> &states = PIECE_TABLE[curType];
+    const FixedWeights fw = toFixed(w);
+
+    struct Cand { int rIdx; int leftC; };
+    std::vector<Cand> cands;
+    for (int rIdx = 0; rIdx < PIECE_ROTATIONS[curType]; ++rIdx) {
+        const PieceMasks &pm = states[rIdx];
+        for (int left = -pm.minCol; left + pm.maxCol < W; ++left)
+            cands.push_back({rIdx, left});
+    }
+
+    std::vector<double> scores(cands.size(), -1e9);
+    std::vector<int> lines(cands.size(), 0);
+
+    // Fold the weight vector into the cache key so searches with
+    // different weights (e.g. the tuner) never alias each other.
+    uint64_t wkey = 0;
+    for (double v : {w.lines, w.hole, w.height, w.bumpy}) {
+        uint64_t bits;
+        memcpy(&bits, &v, sizeof bits);
+        wkey = splitmix64(wkey ^ bits);
+    }
+
+    auto evalCand = [&](int idx) {
+        // Workers share nothing: each candidate evaluates on its own copy
+        // (the inner findBestMove then applies/undoes in place on it).
+        const PieceMasks &pm = states[cands[idx].rIdx];
+        int left = cands[idx].leftC;
+        int top = bb.dropRow(pm, left);
+
+        BitBoardT<W,H> b2 = bb;
+        b2.place(pm, top, left);
+        int ln = b2.clearLines();
+
+        // The inner score is a pure function of (board, next piece,
+        // weights); duplicates from transposing outer candidates hit the
+        // cache instead of re-enumerating the next piece's placements.
+        uint64_t key = b2.hash ^ ZOBRIST_PIECE[nextType] ^ wkey;
+        double innerScore;
+        if (!evalCache().probe(key, innerScore)) {
+            innerScore = findBestMove(b2, nextType, w).score;
+            evalCache().store(key, innerScore);
+        }
+        if (innerScore < -1e8) return;  // next piece has no legal placement
+
+        // Credit the lines this move clears, then let the inner score carry
+        // the next piece's lines and the final board features. Both terms
+        // are fixed-point values over 2^16, so this double addition is
+        // exact and the comparison below stays deterministic.
+        scores[idx] = (double)((int64_t)fw.lines * ln) / FIXED_SCALE + innerScore;
+        lines[idx] = ln;
+    };
+
+    if (pool && cands.size() > 1) {
+        pool->run((int)cands.size(), evalCand);
+    } else {
+        for (int i = 0; i < (int)cands.size(); ++i) evalCand(i);
+    }
+
+    // Serial reduction keeps the result identical to the serial loop
+    // regardless of worker scheduling.
+    MoveDecision best{0,0,-1e9,0};
+    for (int i = 0; i < (int)cands.size(); ++i) {
+        if (scores[i] > best.score)
+            best = {cands[i].rIdx, cands[i].leftC, scores[i], lines[i]};
+    }
+    return best;
+}
+
+template <int W, int H>
+MoveDecision findBestMoveBeam(const BitBoardT<W,H> &bb, const int *pieces, int nPieces,
+                              int beamWidth, long long nodeBudget, const Weights &w) {
+    struct Node {
+        BitBoardT<W,H> board;
+        int64_t g;         // accumulated fixed-point line reward
+        int64_t score;     // g + final board features; the ranking key
+        int16_t rootRot, rootLeft, rootLines;
+    };
+    if (beamWidth < 1) beamWidth = 1;
+    const FixedWeights fw = toFixed(w);
+
+    std::vector<Node> beam, children;
+    beam.reserve(beamWidth);
+    children.reserve((size_t)beamWidth * 4 * W);
+    beam.push_back({bb, 0, 0, -1, -1, 0});
+
+    long long nodes = 0;
+    bool budgetHit = false;
+    for (int ply = 0; ply < nPieces && !budgetHit; ++ply) {
+        int type = pieces[ply];
+        children.clear();
+        for (const Node &n : beam) {
+            for (int rIdx = 0; rIdx < PIECE_ROTATIONS[type] && !budgetHit; ++rIdx) {
+                const PieceMasks &pm = PIECE_TABLE[type][rIdx];
+                for (int left = -pm.minCol; left + pm.maxCol < W; ++left) {
+                    int top = n.board.dropRow(pm, left);
+                    if (top + pm.minRow < 0) continue;   // lock-out
+                    children.push_back(n);
+                    Node &c = children.back();
+                    c.board.place(pm, top, left);
+                    int ln = c.board.clearLines();
+                    c.g += (int64_t)fw.lines * ln;
+                    c.score = c.g + (int64_t)fw.hole * c.board.holes()
+                                  + (int64_t)fw.height * c.board.aggregateHeight()
+                                  + (int64_t)fw.bumpy * c.board.bumpiness();
+                    if (ply == 0) {
+                        c.rootRot = (int16_t)rIdx;
+                        c.rootLeft = (int16_t)left;
+                        c.rootLines = (int16_t)ln;
+                    }
+                    ++nodes;
+                    if (nodeBudget && nodes >= nodeBudget) { budgetHit = true; break; }
+                }
+            }
+            if (budgetHit) break;
+        }
+        if (children.empty()) break;
+
+        std::sort(children.begin(), children.end(),
+                  [](const Node &a, const Node &b) { return a.score > b.score; });
+        beam.clear();
+        for (const Node &c : children) {
+            bool dup = false;
+            for (const Node &k : beam)
+                if (k.board.hash == c.board.hash) { dup = true; break; }
+            if (!dup) {
+                beam.push_back(c);
+                if ((int)beam.size() >= beamWidth) break;
+            }
+        }
+    }
+
+    // Selection keeps the beam sorted, so the front is the best survivor;
+    // rootRot stays -1 only when the first piece had no legal placement.
+    const Node &b0 = beam.front();
+    if (b0.rootRot < 0) return {0, 0, -1e9, 0};
+    return {b0.rootRot, b0.rootLeft, (double)b0.score / FIXED_SCALE, b0.rootLines};
+}
+
+template <int W, int H>
+HeadlessStats playHeadless(Bag &bag, long long maxPieces, bool lookahead,
+                           ThreadPool *pool, const Weights &w,
+                           std::vector<ReplayMove> *record,
+                           int beamDepth, int beamWidth, long long beamBudget) {
+    BitBoardT<W,H> bb;
+    HeadlessStats st;
+    int type = bag.next();
+    int nextType = bag.next();
+    while (maxPieces == 0 || st.pieces < maxPieces) {
+        // Same spawn square updateAI uses; if it is blocked the game is over.
+        if (bb.collides(PIECE_TABLE[type][0], 0, W/2 - 2)) break;
+        MoveDecision mv;
+        if (beamDepth > 1 && beamWidth > 0) {
+            // Known sequence: the current piece, the next, then the bag.
+            int seq[16];
+            int d = beamDepth > 16 ? 16 : beamDepth;
+            seq[0] = type;
+            seq[1] = nextType;
+            for (int i = 2; i < d; ++i) seq[i] = bag.peek(i - 2);
+            mv = findBestMoveBeam(bb, seq, d, beamWidth, beamBudget, w);
+        } else {
+            mv = lookahead ? findBestMoveLookahead(bb, type, nextType, pool, w)
+                           : findBestMove(bb, type, w);
+        }
+        if (mv.score < -1e8) break;
+        const PieceMasks &pm = PIECE_TABLE[type][mv.rotationIndex];
+        int top = bb.dropRow(pm, mv.leftC);
+        // Lock-out: the windowed game silently discards cells locked above
+        // row 0, which would let a headless game run forever. Treat it as
+        // game over so every game terminates.
+        if (top + pm.minRow < 0) break;
+        if (record)
+            record->push_back({(uint8_t)type, (uint8_t)mv.rotationIndex, (int8_t)mv.leftC});
+        bb.place(pm, top, mv.leftC);
+        int cleared = bb.clearLines();
+        st.pieces++;
+        if (cleared > 0) {
+            st.lines += cleared;
+            st.score += 100 * (1 << (cleared - 1));
+        }
+        type = nextType;
+        nextType = bag.next();
+    }
+    return st;
+}
+
+// ==================== EXPLICIT INSTANTIATIONS ====================
+// One block per supported geometry (see SUPPORTED GEOMETRIES in
+// tetris_core.h). Keeping the definitions above template-only and
+// instantiating here preserves the single-translation-unit story: every
+// geometry's search code is still compiled exactly once, in this file,
+// under the same LTO/PGO pipeline.
+#define TETRIS_INSTANTIATE_GEOMETRY(W, H) \
+    template MoveDecision findBestMove<W,H>(const BitBoardT<W,H> &, int, const Weights &); \
+    template MoveDecision findBestMove<W,H>(const BoardT<W,H> &, int); \
+    template MoveDecision findBestMoveLookahead<W,H>(const BitBoardT<W,H> &, int, int, \
+                                                     ThreadPool *, const Weights &); \
+    template MoveDecision findBestMoveBeam<W,H>(const BitBoardT<W,H> &, const int *, int, \
+                                                int, long long, const Weights &); \
+    template HeadlessStats playHeadless<W,H>(Bag &, long long, bool, ThreadPool *, \
+                                             const Weights &, std::vector<ReplayMove> *, \
+                                             int, int, long long);
+
+TETRIS_INSTANTIATE_GEOMETRY(10, 20)   // default board
+TETRIS_INSTANTIATE_GEOMETRY(20, 40)   // research: double scale
+TETRIS_INSTANTIATE_GEOMETRY(40, 80)   // research: quadruple scale
+
+#undef TETRIS_INSTANTIATE_GEOMETRY
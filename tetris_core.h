@@ -0,0 +1,926 @@
+// tetris_core.h
+// Simulation core shared by the windowed games and the headless tools.
+// Pure game logic: board, bitboard, tetromino data, bag randomizer and
+// the heuristic AI search. No raylib, no timers, no I/O, so it can run
+// on a build farm without a display.
+//
+// The hot building blocks (BitBoard, the constexpr piece tables, the
+// feature kernels) are inline here; the search functions and headless
+// loop live in tetris_core.cpp, compiled once into libtetris.a so every
+// binary shares one LTO/PGO-optimized copy (see `make pgo`).
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <type_traits>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+// ==================== CONSTANTS ====================
+// Default geometry; the board classes below are templates over <W, H>
+// and these feed their default aliases. Research geometries (wide-board
+// AI experiments) pick other instantiations — see SUPPORTED GEOMETRIES
+// near the search declarations.
+const int BOARD_W = 10;
+const int BOARD_H = 20;
+
+// AI Heuristic weights
+const double W_LINES = 0.760666;
+const double W_HOLE = -0.35663;
+const double W_HEIGHT = -0.510066;
+const double W_BUMPY = -0.184483;
+
+// The same weights as a value, so the tuner can search over them while
+// every other caller keeps the defaults.
+struct Weights {
+    double lines = W_LINES;
+    double hole = W_HOLE;
+    double height = W_HEIGHT;
+    double bumpy = W_BUMPY;
+};
+
+// Fixed-point view of a weight vector: 16 fractional bits in int32.
+// All scoring happens on these — integer features times integer weights
+// accumulated in int64 — so candidate comparisons are exact and move
+// choices are bit-identical across compilers, FMA settings and
+// architectures (double scoring picked different moves for identical
+// boards on x86 vs ARM, breaking replay verification). Reported scores
+// are fixed/2^16 converted to double, which is exact for any total this
+// board can produce.
+const double FIXED_SCALE = 65536.0;
+struct FixedWeights {
+    int32_t lines, hole, height, bumpy;
+};
+inline FixedWeights toFixed(const Weights &w) {
+    auto q = [](double v) { return (int32_t)std::llround(v * FIXED_SCALE); };
+    return {q(w.lines), q(w.hole), q(w.height), q(w.bumpy)};
+}
+
+// ==================== TETROMINO DEFINITIONS ====================
+// All piece data is compile-time constant: base matrices, their
+// rotations, and the palette index per piece live in .rodata. Nothing
+// allocates at startup and the AI/rendering code indexes flat arrays.
+using Matrix4 = std::array<std::array<int,4>,4>;
+
+constexpr Matrix4 rotate90(const Matrix4 &m) {
+    Matrix4 r{};
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            r[i][j] = m[3 - j][i];
+    return r;
+}
+
+// Spawn orientations, piece order I, J, L, O, S, T, Z.
+constexpr std::array<Matrix4,7> TETROMINO_BASE = {
+    Matrix4{{ {0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0} }},  // I
+    Matrix4{{ {1,0,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0} }},  // J
+    Matrix4{{ {0,0,1,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0} }},  // L
+    Matrix4{{ {0,1,1,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0} }},  // O
+    Matrix4{{ {0,1,1,0}, {1,1,0,0}, {0,0,0,0}, {0,0,0,0} }},  // S
+    Matrix4{{ {0,1,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0} }},  // T
+    Matrix4{{ {1,1,0,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0} }},  // Z
+};
+
+// Palette index per piece (matches the colors the original games used).
+constexpr std::array<int,7> TETROMINO_COLOR = {1, 4, 5, 2, 6, 3, 7};
+
+constexpr std::array<std::array<Matrix4,4>,7> buildTetrominoStates() {
+    std::array<std::array<Matrix4,4>,7> t{};
+    for (int p = 0; p < 7; ++p) {
+        t[p][0] = TETROMINO_BASE[p];
+        for (int r = 1; r < 4; ++r)
+            t[p][r] = rotate90(t[p][r-1]);
+    }
+    return t;
+}
+
+// TETROMINO_STATES[type][rotation]; only the first PIECE_ROTATIONS[type]
+// entries are distinct (defined below with the bitmask tables).
+inline constexpr std::array<std::array<Matrix4,4>,7> TETROMINO_STATES = buildTetrominoStates();
+
+// ==================== BOARD CLASS ====================
+// Compile-time dimensions: every loop bound below is a constant the
+// optimizer can propagate and unroll against, exactly as with the old
+// globals — the alternative (runtime-sized vectors) costs indirection in
+// the innermost loops. `Board` stays an alias for the default geometry,
+// so existing callers are untouched.
+template <int W, int H>
+class BoardT {
+public:
+    std::array<std::array<int, W>, H> cells{};
+
+    BoardT() {
+        for (auto &row : cells) row.fill(0);
+    }
+
+    bool inBounds(int r, int c) const {
+        return r >= 0 && r < H && c >= 0 && c < W;
+    }
+
+    bool collides(const Matrix4 &shape, int topR, int leftC) const {
+        for (int i=0;i<4;i++) {
+            for (int j=0;j<4;j++) {
+                if (!shape[i][j]) continue;
+                int r = topR + i;
+                int c = leftC + j;
+                if (c < 0 || c >= W || r >= H) return true;
+                if (r >= 0 && cells[r][c] != 0) return true;
+            }
+        }
+        return false;
+    }
+
+    void placePiece(const Matrix4 &shape, int topR, int leftC, int colorId) {
+        for (int i=0;i<4;i++) {
+            for (int j=0;j<4;j++) {
+                if (shape[i][j]) {
+                    int r = topR + i;
+                    int c = leftC + j;
+                    if (r >= 0 && r < H && c >= 0 && c < W)
+                        cells[r][c] = colorId;
+                }
+            }
+        }
+    }
+
+    int clearLines() {
+        int cleared = 0;
+        for (int r = H - 1; r >= 0; --r) {
+            bool full = true;
+            for (int c = 0; c < W; ++c)
+                if (cells[r][c] == 0) { full = false; break; }
+            if (full) {
+                cleared++;
+                for (int rr = r; rr > 0; --rr)
+                    cells[rr] = cells[rr-1];
+                cells[0].fill(0);
+                r++;
+            }
+        }
+        return cleared;
+    }
+
+    int dropPosition(const Matrix4 &shape, int leftC) const {
+        int topR = -4;
+        while (!collides(shape, topR + 1, leftC)) topR++;
+        if (collides(shape, topR, leftC)) return INT_MIN;
+        return topR;
+    }
+
+    int columnHeight(int c) const {
+        for (int r = 0; r < H; ++r)
+            if (cells[r][c] != 0) return H - r;
+        return 0;
+    }
+
+    int aggregateHeight() const {
+        int s = 0;
+        for (int c=0;c<W;c++) s += columnHeight(c);
+        return s;
+    }
+
+    int bumpiness() const {
+        int b = 0;
+        for (int c=0;c<W-1;c++)
+            b += abs(columnHeight(c) - columnHeight(c+1));
+        return b;
+    }
+
+    int holes() const {
+        int h = 0;
+        for (int c=0;c<W;c++) {
+            bool blockFound = false;
+            for (int r=0;r<H;r++) {
+                if (cells[r][c] != 0) blockFound = true;
+                else if (blockFound) h++;
+            }
+        }
+        return h;
+    }
+};
+
+using Board = BoardT<BOARD_W, BOARD_H>;
+
+// ==================== BITBOARD ====================
+// Row-mask board used by the AI search. Each row is one integer with
+// bit c set when cell (r,c) is occupied, so collision is a few ANDs and
+// a full row compares equal to the full-row mask. The mask type follows
+// the board width: 16 bits cover the classic board, wider research
+// geometries move to 32- or 64-bit rows (widths up to 63). Color
+// information stays in Board::cells and is only touched by the renderer.
+template <int W>
+using RowMask = std::conditional_t<(W <= 16), uint16_t,
+                std::conditional_t<(W <= 32), uint32_t, uint64_t>>;
+
+template <int W>
+constexpr RowMask<W> fullRowMask() {
+    static_assert(W >= 4 && W < 64, "unsupported board width");
+    return (RowMask<W>)((1ull << W) - 1);
+}
+
+// Default-geometry mask, kept as a named constant for callers that build
+// boards by hand (bench fixtures and the like).
+const uint16_t FULL_ROW = fullRowMask<BOARD_W>();
+
+// Per-rotation piece masks: one row mask per row of the 4x4 matrix,
+// bit j = column j, plus the occupied row/column span for bounds checks
+// and the per-column top/bottom profile (every tetromino column is a
+// contiguous run of cells) used for incremental stat updates and for
+// computing the drop row from cached column heights.
+struct PieceMasks {
+    std::array<uint16_t,4> rows;
+    int minRow, maxRow;
+    int minCol, maxCol;
+    std::array<int8_t,4> colTop;   // topmost occupied row per column, -1 if empty
+    std::array<int8_t,4> colBot;   // bottommost occupied row per column
+};
+
+// The rotation states are fixed data, so the whole table is built at
+// compile time and lives in .rodata. Base shapes are the TETROMINO_BASE
+// matrices packed row-major into 16 bits (bit i*4+j).
+constexpr std::array<uint16_t,7> PIECE_SHAPES = {
+    0x00F0,  // I
+    0x0071,  // J
+    0x0074,  // L
+    0x0066,  // O
+    0x0036,  // S
+    0x0072,  // T
+    0x0063   // Z
+};
+constexpr std::array<int,7> PIECE_ROTATIONS = {2, 4, 4, 1, 2, 4, 2};
+
+// Same transform as rotate90: r[i][j] = m[3-j][i].
+constexpr uint16_t rotatePattern(uint16_t m) {
+    uint16_t r = 0;
+    for (int i=0;i<4;i++)
+        for (int j=0;j<4;j++)
+            if ((m >> ((3-j)*4 + i)) & 1) r |= (uint16_t)(1u << (i*4 + j));
+    return r;
+}
+
+constexpr PieceMasks makeMasks(uint16_t pat) {
+    PieceMasks pm{};
+    pm.minRow = 4; pm.maxRow = -1;
+    pm.minCol = 4; pm.maxCol = -1;
+    for (int j=0;j<4;j++) { pm.colTop[j] = -1; pm.colBot[j] = -1; }
+    for (int i=0;i<4;i++) {
+        for (int j=0;j<4;j++) {
+            if (!((pat >> (i*4 + j)) & 1)) continue;
+            pm.rows[i] = (uint16_t)(pm.rows[i] | (1u << j));
+            pm.minRow = pm.minRow < i ? pm.minRow : i;
+            pm.maxRow = pm.maxRow > i ? pm.maxRow : i;
+            pm.minCol = pm.minCol < j ? pm.minCol : j;
+            pm.maxCol = pm.maxCol > j ? pm.maxCol : j;
+            if (pm.colTop[j] < 0) pm.colTop[j] = (int8_t)i;
+            pm.colBot[j] = (int8_t)i;
+        }
+    }
+    return pm;
+}
+
+constexpr std::array<std::array<PieceMasks,4>,7> buildPieceTable() {
+    std::array<std::array<PieceMasks,4>,7> table{};
+    for (int t=0;t<7;t++) {
+        uint16_t pat = PIECE_SHAPES[t];
+        for (int r=0;r<4;r++) {
+            table[t][r] = makeMasks(pat);
+            pat = rotatePattern(pat);
+        }
+    }
+    return table;
+}
+
+// PIECE_TABLE[type][rotation]; only the first PIECE_ROTATIONS[type]
+// entries are distinct states, matching the TETROMINO_STATES order.
+inline constexpr std::array<std::array<PieceMasks,4>,7> PIECE_TABLE = buildPieceTable();
+
+// ==================== FEATURE KERNELS ====================
+// Whole-board holes and aggregate height from the row masks. Both are a
+// running OR down the rows: holes counts bits newly covered from above,
+// aggregate height counts bits of the running OR per row. The SIMD path
+// does eight rows per step: an in-register prefix OR (three shift+OR
+// steps), then a nibble-LUT popcount summed with psadbw. The carry is a
+// single row mask, so a 20-row board is two vector blocks plus a scalar
+// tail; wider AVX2 vectors buy nothing here because the carry is
+// sequential across 128-bit lanes anyway. The SIMD layout is specific to
+// 16-bit rows, so the wider research masks take the scalar loop only.
+#if defined(__SSSE3__)
+inline __m128i popcountBytes(__m128i v) {
+    const __m128i lut = _mm_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m128i low = _mm_set1_epi8(0x0F);
+    __m128i lo = _mm_and_si128(v, low);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low);
+    return _mm_add_epi8(_mm_shuffle_epi8(lut, lo), _mm_shuffle_epi8(lut, hi));
+}
+#endif
+
+template <typename Mask, size_t H>
+inline void featureHolesAgg(const std::array<Mask, H> &rows,
+                            int &holesOut, int &aggOut) {
+    int holes = 0, agg = 0;
+    Mask carry = 0;
+    int r = 0;
+#if defined(__SSSE3__)
+    if constexpr (sizeof(Mask) == 2) {
+        __m128i holesAcc = _mm_setzero_si128();
+        __m128i aggAcc = _mm_setzero_si128();
+        const __m128i zero = _mm_setzero_si128();
+        for (; r + 8 <= (int)H; r += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i *)&rows[r]);
+            __m128i p = v;
+            p = _mm_or_si128(p, _mm_slli_si128(p, 2));
+            p = _mm_or_si128(p, _mm_slli_si128(p, 4));
+            p = _mm_or_si128(p, _mm_slli_si128(p, 8));
+            __m128i carryV = _mm_set1_epi16((short)carry);
+            __m128i cum = _mm_or_si128(p, carryV);
+            __m128i cumPrev = _mm_or_si128(_mm_slli_si128(p, 2), carryV);
+            __m128i holesV = _mm_andnot_si128(v, cumPrev);
+            holesAcc = _mm_add_epi64(holesAcc, _mm_sad_epu8(popcountBytes(holesV), zero));
+            aggAcc = _mm_add_epi64(aggAcc, _mm_sad_epu8(popcountBytes(cum), zero));
+            carry = (Mask)_mm_extract_epi16(cum, 7);
+        }
+        holes = (int)(_mm_cvtsi128_si64(holesAcc) +
+                      _mm_cvtsi128_si64(_mm_unpackhi_epi64(holesAcc, holesAcc)));
+        agg = (int)(_mm_cvtsi128_si64(aggAcc) +
+                    _mm_cvtsi128_si64(_mm_unpackhi_epi64(aggAcc, aggAcc)));
+    }
+#endif
+    for (; r < (int)H; ++r) {
+        // carry never has bits outside the playfield, so the AND also
+        // masks the high bits ~ turns on.
+        holes += __builtin_popcountll((uint64_t)(Mask)(carry & ~rows[r]));
+        carry |= rows[r];
+        agg += __builtin_popcountll((uint64_t)carry);
+    }
+    holesOut = holes;
+    aggOut = agg;
+}
+
+// ==================== ZOBRIST HASHING ====================
+// One 64-bit key per cell, generated at compile time with splitmix64 so
+// the tables are identical across builds. XORing the keys of every
+// occupied cell gives a board signature that updates incrementally:
+// placing a piece XORs four keys, and the paths that already pay for a
+// full stat rescan rebuild the hash alongside.
+constexpr uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+template <int W, int H>
+constexpr std::array<std::array<uint64_t, W>, H> buildZobristCells() {
+    std::array<std::array<uint64_t, W>, H> t{};
+    uint64_t s = 0;
+    for (int r = 0; r < H; ++r)
+        for (int c = 0; c < W; ++c)
+            t[r][c] = s = splitmix64(s);
+    return t;
+}
+// One table per instantiated geometry (each starts the splitmix chain at
+// 0, so the tables differ only in extent).
+template <int W, int H>
+inline constexpr std::array<std::array<uint64_t, W>, H> ZOBRIST_CELL =
+    buildZobristCells<W, H>();
+
+// Distinguishes "same board, different piece to place" in cache keys.
+constexpr std::array<uint64_t,7> buildZobristPiece() {
+    std::array<uint64_t,7> t{};
+    uint64_t s = splitmix64(BOARD_H * BOARD_W);
+    for (int p = 0; p < 7; ++p)
+        t[p] = s = splitmix64(s);
+    return t;
+}
+inline constexpr std::array<uint64_t,7> ZOBRIST_PIECE = buildZobristPiece();
+
+template <int W, int H>
+struct BitBoardT {
+    using Mask = RowMask<W>;
+    static constexpr Mask FULL = fullRowMask<W>();
+    static_assert(H < 128, "column heights are cached in int8_t");
+
+    std::array<Mask, H> rows{};
+    // Cached statistics, kept in sync by place()/clearLines() so the
+    // heuristic evaluation never rescans the grid. place() touches at most
+    // the four columns of the piece; a line clear shifts every column, so
+    // only that path pays for a full recompute.
+    std::array<int8_t, W> hts{};
+    int16_t holeCnt = 0;
+    int16_t aggH = 0;
+    // Zobrist signature of the occupied cells, maintained with the stats.
+    uint64_t hash = 0;
+
+    BitBoardT() = default;
+    explicit BitBoardT(const BoardT<W,H> &b) {
+        for (int r=0;r<H;r++) {
+            Mask m = 0;
+            for (int c=0;c<W;c++)
+                if (b.cells[r][c] != 0) m |= (Mask)((Mask)1 << c);
+            rows[r] = m;
+        }
+        recomputeStats();
+    }
+
+    static uint64_t hashRows(const std::array<Mask, H> &rows) {
+        uint64_t h = 0;
+        for (int r = 0; r < H; ++r) {
+            Mask m = rows[r];
+            while (m) {
+                h ^= ZOBRIST_CELL<W,H>[r][__builtin_ctzll((uint64_t)m)];
+                m &= (Mask)(m - 1);
+            }
+        }
+        return h;
+    }
+
+    void recomputeStats() {
+        int h, a;
+        featureHolesAgg(rows, h, a);
+        holeCnt = (int16_t)h;
+        aggH = (int16_t)a;
+        hash = hashRows(rows);
+        hts.fill(0);
+        Mask cum = 0;
+        for (int r=0;r<H;r++) {
+            Mask newly = rows[r] & (Mask)~cum;
+            while (newly) {
+                int c = __builtin_ctzll((uint64_t)newly);
+                hts[c] = (int8_t)(H - r);
+                newly &= (Mask)(newly - 1);
+            }
+            cum |= rows[r];
+            if (cum == FULL) break;
+        }
+    }
+
+    // Shift the piece's row mask to board columns; sets *offBoard when a
+    // filled cell would leave the playfield horizontally. The piece masks
+    // are 4 bits wide, so a 64-bit intermediate covers every supported
+    // width without overflow.
+    static Mask shiftRow(uint16_t m, int leftC, bool *offBoard) {
+        if (leftC >= 0) {
+            uint64_t s = (uint64_t)m << leftC;
+            if (s & ~(uint64_t)FULL) *offBoard = true;
+            return (Mask)(s & FULL);
+        }
+        if (m & ((1u << -leftC) - 1)) *offBoard = true;
+        return (Mask)(m >> -leftC);
+    }
+
+    bool collides(const PieceMasks &pm, int topR, int leftC) const {
+        for (int i = pm.minRow; i <= pm.maxRow; ++i) {
+            bool off = false;
+            Mask m = shiftRow(pm.rows[i], leftC, &off);
+            if (off) return true;
+            int r = topR + i;
+            if (r >= H) return true;
+            if (r >= 0 && (rows[r] & m)) return true;
+        }
+        return false;
+    }
+
+    void place(const PieceMasks &pm, int topR, int leftC) {
+        for (int i = pm.minRow; i <= pm.maxRow; ++i) {
+            bool off = false;
+            Mask m = shiftRow(pm.rows[i], leftC, &off);
+            int r = topR + i;
+            if (r >= 0 && r < H) {
+                rows[r] |= m;
+                // The cells were empty, so XOR sets their keys.
+                while (m) {
+                    hash ^= ZOBRIST_CELL<W,H>[r][__builtin_ctzll((uint64_t)m)];
+                    m &= (Mask)(m - 1);
+                }
+            }
+        }
+        if (topR + pm.minRow < 0) {
+            // Cells clipped above the board: the contiguous-column argument
+            // below no longer holds, fall back to the full rescan.
+            recomputeStats();
+            return;
+        }
+        // Incremental update: a dropped piece can only land on top of each
+        // column's stack (it cannot tuck under an overhang), so per touched
+        // column the new surface is the piece's top cell and every empty
+        // cell between the piece's bottom cell and the old surface becomes
+        // a hole.
+        for (int j = pm.minCol; j <= pm.maxCol; ++j) {
+            if (pm.colTop[j] < 0) continue;
+            int c = leftC + j;
+            int oldTopRow = H - hts[c];
+            int newTopRow = topR + pm.colTop[j];
+            int botRow = topR + pm.colBot[j];
+            holeCnt = (int16_t)(holeCnt + (oldTopRow - botRow - 1));
+            hts[c] = (int8_t)(H - newTopRow);
+            aggH = (int16_t)(aggH + (oldTopRow - newTopRow));
+        }
+    }
+
+    int clearLines() {
+        int cleared = 0;
+        for (int r = H - 1; r >= 0; --r) {
+            if (rows[r] == FULL) {
+                cleared++;
+                for (int rr = r; rr > 0; --rr) rows[rr] = rows[rr-1];
+                rows[0] = 0;
+                r++;
+            }
+        }
+        // A cleared row removes a cell from every column and shifts the
+        // rows above, so every cached column changes at once.
+        if (cleared > 0) recomputeStats();
+        return cleared;
+    }
+
+    int dropPosition(const PieceMasks &pm, int leftC) const {
+        int topR = -4;
+        while (!collides(pm, topR + 1, leftC)) topR++;
+        if (collides(pm, topR, leftC)) return INT_MIN;
+        return topR;
+    }
+
+    // Drop row straight from the cached column heights: a straight drop
+    // stops when the binding column's bottom cell reaches that column's
+    // surface, so the descent loop collapses to one min() over the piece's
+    // columns. leftC must keep the piece inside the walls.
+    int dropRow(const PieceMasks &pm, int leftC) const {
+        int topR = INT_MAX;
+        for (int j = pm.minCol; j <= pm.maxCol; ++j) {
+            int t = H - hts[leftC + j] - 1 - pm.colBot[j];
+            topR = topR < t ? topR : t;
+        }
+        return topR;
+    }
+
+    // Everything applyMove changes that cannot be cheaply re-derived:
+    // which rows were removed (they were full, so their contents are
+    // implied) and the stat snapshot from before the move.
+    struct MoveUndo {
+        const PieceMasks *pm;
+        int topR, leftC;
+        int cleared;
+        std::array<int8_t,4> clearedAt;     // row index at time of removal
+        std::array<int8_t, W> hts;
+        int16_t holeCnt, aggH;
+        uint64_t hash;
+    };
+
+    // Place a piece, clear lines, and record how to reverse both, so the
+    // search can evaluate a candidate without copying the board. Returns
+    // the number of lines cleared.
+    int applyMove(const PieceMasks &pm, int topR, int leftC, MoveUndo &u) {
+        u.pm = &pm; u.topR = topR; u.leftC = leftC; u.cleared = 0;
+        u.hts = hts; u.holeCnt = holeCnt; u.aggH = aggH; u.hash = hash;
+        place(pm, topR, leftC);
+        for (int r = H - 1; r >= 0; --r) {
+            if (rows[r] == FULL) {
+                u.clearedAt[u.cleared++] = (int8_t)r;
+                for (int rr = r; rr > 0; --rr) rows[rr] = rows[rr-1];
+                rows[0] = 0;
+                r++;
+            }
+        }
+        if (u.cleared > 0) recomputeStats();
+        return u.cleared;
+    }
+
+    void undoMove(const MoveUndo &u) {
+        // Reinsert cleared rows in reverse removal order, then strip the
+        // piece cells and restore the stat snapshot.
+        for (int k = u.cleared - 1; k >= 0; --k) {
+            int r = u.clearedAt[k];
+            for (int rr = 0; rr < r; ++rr) rows[rr] = rows[rr+1];
+            rows[r] = FULL;
+        }
+        const PieceMasks &pm = *u.pm;
+        for (int i = pm.minRow; i <= pm.maxRow; ++i) {
+            bool off = false;
+            Mask m = shiftRow(pm.rows[i], u.leftC, &off);
+            int r = u.topR + i;
+            if (r >= 0 && r < H) rows[r] = (Mask)(rows[r] & ~m);
+        }
+        hts = u.hts; holeCnt = u.holeCnt; aggH = u.aggH; hash = u.hash;
+    }
+
+    int holes() const { return holeCnt; }
+
+    int aggregateHeight() const { return aggH; }
+
+    int columnHeight(int c) const { return hts[c]; }
+
+    int bumpiness() const {
+        int b = 0;
+        for (int c=0;c<W-1;c++) b += abs((int)hts[c] - (int)hts[c+1]);
+        return b;
+    }
+};
+
+using BitBoard = BitBoardT<BOARD_W, BOARD_H>;
+
+// ==================== AI DECISION ====================
+struct MoveDecision {
+    int rotationIndex;
+    int leftC;
+    double score;
+    int lines;
+};
+
+// One move as recorded in replays: with the bag seed this reconstructs
+// the game exactly. 3 bytes per move (see tetris_replay.h).
+struct ReplayMove {
+    uint8_t type;
+    uint8_t rotation;
+    int8_t leftC;
+};
+
+// ==================== SUPPORTED GEOMETRIES ====================
+// The searches below are templates over the board dimensions so the
+// compiler sees W and H as constants in the hot loops (fixed trip
+// counts, no runtime-sized buffers), exactly as it did when the board
+// was a plain 10x20 struct. The definitions live in tetris_core.cpp and
+// are explicitly instantiated there for the geometries the research
+// mode supports:
+//
+//     10 x 20   (default; uint16_t rows, SSSE3 feature pass)
+//     20 x 40   (uint32_t rows)
+//     40 x 80   (uint64_t rows)
+//
+// Other dimensions compile in the header-only code (Board/BitBoard,
+// features) but have no search instantiation; add one at the bottom of
+// tetris_core.cpp if a new geometry is needed.
+
+// Single-ply greedy: every (rotation, column) placement of the piece,
+// scored by the board features after the clear. Applies and reverses
+// candidates in place on one working copy.
+template <int W, int H>
+MoveDecision findBestMove(const BitBoardT<W,H> &bb, int pieceType,
+                          const Weights &w = Weights{});
+template <int W, int H>
+MoveDecision findBestMove(const BoardT<W,H> &board, int pieceType);
+
+// ==================== THREAD POOL ====================
+// Persistent worker pool for the AI search: workers are started once and
+// pick job indexes off a shared counter, so a parallel-for costs two
+// condvar signals instead of thread spawns.
+class ThreadPool {
+public:
+    explicit ThreadPool(int n = (int)std::thread::hardware_concurrency()) {
+        if (n < 1) n = 1;
+        for (int i = 0; i < n; ++i)
+            workers.emplace_back([this]{ workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            stopping = true;
+        }
+        cvWork.notify_all();
+        for (auto &w : workers) w.join();
+    }
+
+    int size() const { return (int)workers.size(); }
+
+    // Runs job(0..jobCount-1) across the workers and blocks until all
+    // indexes have completed. The caller participates too, so a pool is
+    // never slower than the serial loop.
+    void run(int jobCount, const std::function<void(int)> &job) {
+        if (jobCount <= 0) return;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            task = &job;
+            total = jobCount;
+            nextIndex.store(0, std::memory_order_relaxed);
+            finished = 0;
+        }
+        cvWork.notify_all();
+        drain(job);
+        std::unique_lock<std::mutex> lk(mtx);
+        // Wait for the workers to leave drain(), not just for the last
+        // index to complete: after its final job a worker makes one more
+        // claim attempt, reading the counters (and holding the job
+        // pointer) outside the mutex. Returning earlier would let the
+        // caller destroy `job` and the next run() reset the counters
+        // under that stale iteration, handing it an index of the new run
+        // against the old function object.
+        cvDone.wait(lk, [this]{ return finished == total && draining == 0; });
+        task = nullptr;
+    }
+
+private:
+    void drain(const std::function<void(int)> &job) {
+        for (;;) {
+            int i = nextIndex.fetch_add(1, std::memory_order_relaxed);
+            if (i >= total) return;
+            job(i);
+            std::unique_lock<std::mutex> lk(mtx);
+            if (++finished == total) cvDone.notify_all();
+        }
+    }
+
+    void workerLoop() {
+        for (;;) {
+            const std::function<void(int)> *job;
+            {
+                std::unique_lock<std::mutex> lk(mtx);
+                cvWork.wait(lk, [this]{
+                    return stopping || (task && nextIndex.load(std::memory_order_relaxed) < total);
+                });
+                if (stopping) return;
+                job = task;
+                ++draining;
+            }
+            drain(*job);
+            {
+                std::unique_lock<std::mutex> lk(mtx);
+                if (--draining == 0) cvDone.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable cvWork, cvDone;
+    const std::function<void(int)> *task = nullptr;
+    std::atomic<int> nextIndex{0};
+    int total = 0;
+    int finished = 0;
+    int draining = 0;       // workers currently inside drain()
+    bool stopping = false;
+};
+
+// Shared pool for AI searches; created on first use and kept for the
+// lifetime of the process.
+ThreadPool &aiThreadPool();
+
+// ==================== EVALUATION CACHE ====================
+// Direct-mapped transposition table in front of the inner ply of the
+// lookahead search: different outer (rotation, column) candidates often
+// collapse to the same post-clear board, and each duplicate would pay a
+// full inner findBestMove enumeration. Fixed-size and allocation-free,
+// so a lookup is one index plus one key compare; a collision simply
+// overwrites, which is safe because the cached value is a pure function
+// of the key. Per-thread so pool workers never contend.
+class EvalCache {
+public:
+    bool probe(uint64_t key, double &score) const {
+        const Entry &e = entries[key & (SIZE - 1)];
+        if (e.key != key) return false;
+        score = e.score;
+        return true;
+    }
+
+    void store(uint64_t key, double score) {
+        entries[key & (SIZE - 1)] = {key, score};
+    }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        double score = 0.0;
+    };
+    static const size_t SIZE = 1 << 15;   // 512KB per thread
+    std::array<Entry, SIZE> entries{};
+};
+
+// The calling thread's cache instance.
+EvalCache &evalCache();
+
+// ==================== LOOKAHEAD SEARCH ====================
+// Two-ply search: every (rotation, column) candidate for the current
+// piece is scored by the best placement of the already-known next piece
+// on the resulting board. The outer candidates (~40) are distributed
+// across the pool; each one costs a full inner findBestMove, so the
+// two-ply search is ~40x the single-ply work.
+template <int W, int H>
+MoveDecision findBestMoveLookahead(const BitBoardT<W,H> &bb, int curType, int nextType,
+                                   ThreadPool *pool = nullptr,
+                                   const Weights &w = Weights{});
+
+// ==================== BEAM SEARCH ====================
+// Depth-N search over a known upcoming piece sequence. Exhaustive
+// depth-N is ~34^N placements; the beam keeps only the beamWidth best
+// boards per ply (ranked by accumulated line reward plus the board
+// features), so cost is linear in depth at beamWidth*34 expansions per
+// ply. nodeBudget caps total expansions so one decision never exceeds
+// its time slice. Zobrist duplicates are dropped at selection:
+// transposed move orders reach identical boards whose subtrees would
+// otherwise be searched several times over.
+template <int W, int H>
+MoveDecision findBestMoveBeam(const BitBoardT<W,H> &bb, const int *pieces, int nPieces,
+                              int beamWidth, long long nodeBudget = 0,
+                              const Weights &w = Weights{});
+
+// ==================== BAG RANDOMIZER ====================
+// xoshiro256** behind the standard URBG interface so std::shuffle can
+// drive it. 32 bytes of state and no warmup, against ~2.5KB and a
+// 624-word init for the mt19937 it replaces — the tuner and tournament
+// modes construct thousands of Bags. Seeded from one 64-bit value
+// through a splitmix64 chain, so nearby seeds still give well-separated
+// states.
+struct Xoshiro256 {
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t sd = 0) { seed(sd); }
+
+    void seed(uint64_t sd) {
+        for (auto &x : s) x = sd = splitmix64(sd);
+    }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+    uint64_t operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Raw state in/out, so a game snapshot can restore the generator
+    // mid-sequence (see the save/resume support in tetris_merged.cpp).
+    std::array<uint64_t,4> state() const { return s; }
+    void setState(const std::array<uint64_t,4> &st) { s = st; }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    std::array<uint64_t,4> s{};
+};
+
+struct Bag {
+    std::vector<int> bag;
+    Xoshiro256 rng;
+
+    // Interactive games: seed from the clock. Anything that wants a
+    // reproducible piece sequence passes an explicit seed instead.
+    Bag() : Bag((uint64_t)std::chrono::high_resolution_clock::now()
+                    .time_since_epoch().count()) {}
+
+    explicit Bag(uint64_t seed) : rng(seed) {
+        refill();
+    }
+
+    void refill() {
+        bag.clear();
+        for (int i=0;i<7;i++) bag.push_back(i);
+        std::shuffle(bag.begin(), bag.end(), rng);
+    }
+
+    int next() {
+        if (bag.empty()) refill();
+        int t = bag.back();
+        bag.pop_back();
+        return t;
+    }
+
+    // The i-th upcoming piece (0 = what next() will return). Peeking past
+    // the current bag draws the following bag early; the bags are shuffled
+    // in the same order either way, so the sequence next() produces is
+    // unchanged.
+    int peek(int i) {
+        while ((int)bag.size() <= i) {
+            std::array<int,7> b{0,1,2,3,4,5,6};
+            std::shuffle(b.begin(), b.end(), rng);
+            bag.insert(bag.begin(), b.begin(), b.end());
+        }
+        return bag[bag.size() - 1 - i];
+    }
+};
+
+// ==================== HEADLESS SIMULATION ====================
+// One complete AI game on the bitboard, as fast as the CPU allows: no
+// cooldown timers, no rendering. Scoring matches Game::updateAI.
+struct HeadlessStats {
+    int score = 0;
+    int lines = 0;
+    long long pieces = 0;
+};
+
+template <int W = BOARD_W, int H = BOARD_H>
+HeadlessStats playHeadless(Bag &bag, long long maxPieces = 0,
+                           bool lookahead = false, ThreadPool *pool = nullptr,
+                           const Weights &w = Weights{},
+                           std::vector<ReplayMove> *record = nullptr,
+                           int beamDepth = 0, int beamWidth = 0,
+                           long long beamBudget = 0);
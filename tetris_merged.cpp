@@ -9,38 +9,44 @@
 //  - 10x20 board with 7-bag randomizer
 //  - Collision detection and line clearing
 //  - Scoring system with level progression
+//  - Simulation runs on its own fixed-timestep thread; the render loop
+//    reads lock-free snapshots, so deep AI searches never drop frames
+//  - Manual input sampled by a 1kHz thread with per-key DAS/ARR repeat
+//  - Kiosk save/resume: --save snapshots the game atomically, --resume
+//    restores it at startup and skips the menus entirely
+//  - Turbo fast-forward for AI games (T cycles x1/x10/x100/MAX)
+//  - Tournament mode: 64 concurrent AI games, one sim thread per core,
+//    tiled rendering with a live leaderboard
 //
 // Build (Linux):
-//   g++ -std=c++17 tetris_merged.cpp -o tetris_merged -lraylib -lGL -lm -lpthread -ldl -lrt -lX11
+//   make tetris_merged
 // Build (Windows - MSYS2):
-//   g++ -std=c++17 tetris_merged.cpp -o tetris_merged.exe -lraylib -lopengl32 -lgdi32 -lwinmm
+//   g++ -std=c++17 -O2 tetris_merged.cpp tetris_core.cpp -o tetris_merged.exe -lraylib -lopengl32 -lgdi32 -lwinmm
 
 #include <raylib.h>
+#include <rlgl.h>
+#include "tetris_core.h"
+#include "tetris_prof.h"
 #include <vector>
 #include <array>
 #include <algorithm>
-#include <random>
-#include <chrono>
 #include <string>
-#include <limits>
 #include <iostream>
-#include <climits>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <cstdio>
+#include <cstring>
 
 using namespace std;
 
 // ==================== CONSTANTS ====================
-const int BOARD_W = 10;
-const int BOARD_H = 20;
 const int CELL = 24;
 const int WINDOW_W = 640;
 const int WINDOW_H = 720;
 
-// AI Heuristic weights
-const double W_LINES = 0.760666;
-const double W_HOLE = -0.35663;
-const double W_HEIGHT = -0.510066;
-const double W_BUMPY = -0.184483;
-
 // ==================== ENUMS ====================
 enum GameState {
     MAIN_MENU,
@@ -51,11 +57,32 @@ enum GameState {
 
 enum GameMode {
     MANUAL,
-    AI
+    AI,
+    TOURNAMENT
 };
 
+// Tournament mode: independent AI games sharded across one sim thread
+// per core. Their cooldown is short so the demo stays lively.
+const int TOURNEY_GAMES = 64;
+const float TOURNEY_COOLDOWN = 0.12f;
+
+// AI search presets, cycled with LEFT/RIGHT on the mode-select screen.
+// depth 0 selects the two-ply lookahead; otherwise beam(depth, width)
+// with a hard node budget so one decision never blows its time slice.
+struct AiPreset {
+    const char *name;
+    int depth;
+    int width;
+    long long budget;
+};
+static const AiPreset AI_PRESETS[] = {
+    {"2-ply lookahead", 0, 0, 0},
+    {"beam depth 3, width 100", 3, 100, 50000},
+    {"beam depth 6, width 200", 6, 200, 400000},
+};
+static const int AI_PRESET_COUNT = (int)(sizeof(AI_PRESETS)/sizeof(AI_PRESETS[0]));
+
 // ==================== TETROMINO DEFINITIONS ====================
-using Matrix4 = std::array<std::array<int,4>,4>;
 
 static const array<array<int,16>,7> TETROMINO_CLASSIC = {
     // I
@@ -78,295 +105,373 @@ static const array<Color,8> PALETTE = {
     BLACK, SKYBLUE, YELLOW, MAGENTA, BLUE, ORANGE, GREEN, RED
 };
 
-struct Tetromino {
-    vector<Matrix4> states;
-    int colorId;
-};
 
-// ==================== UTILITY FUNCTIONS ====================
-Matrix4 rotate90(const Matrix4 &m) {
-    Matrix4 r{};
-    for (int i = 0; i < 4; ++i)
-        for (int j = 0; j < 4; ++j)
-            r[i][j] = m[3 - j][i];
-    return r;
-}
+// ==================== PIECE STRUCTURE ====================
+struct Piece {
+    int type;
+    int x, y;
+    int rotation;
+};
 
-vector<Tetromino> makeTetrominoes() {
-    vector<Tetromino> T(7);
-    
-    // I
-    Matrix4 I0 = {{
-        {0,0,0,0}, {1,1,1,1}, {0,0,0,0}, {0,0,0,0}
-    }};
-    T[0].states = {I0, rotate90(I0)};
-    T[0].colorId = 1;
+// ==================== SIMULATION / RENDER DECOUPLING ====================
+// The game (including the AI search) runs on its own thread at a fixed
+// timestep, so cranking the search depth slows the piece rate, never the
+// framerate. Manual-mode input comes from a dedicated 1kHz sampling
+// thread (below); the sim thread publishes an immutable snapshot of the
+// game through a lock-free triple buffer that the render loop picks up
+// whenever it draws.
 
-    // J
-    Matrix4 J0 = {{
-        {1,0,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}
-    }};
-    for (int i=0;i<4;i++) {
-        if (i==0) T[1].states.push_back(J0);
-        else T[1].states.push_back(rotate90(T[1].states.back()));
-    }
-    T[1].colorId = 4;
+const float SIM_DT = 1.0f / 120.0f;
 
-    // L
-    Matrix4 L0 = {{
-        {0,0,1,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}
-    }};
-    for (int i=0;i<4;i++) {
-        if (i==0) T[2].states.push_back(L0);
-        else T[2].states.push_back(rotate90(T[2].states.back()));
-    }
-    T[2].colorId = 5;
+// Turbo fast-forward for AI games, cycled with T. Multiplier 1 is the
+// normal pacing, 0 means unlimited: placements are then bounded only by
+// TURBO_TICK_BUDGET per sim tick, which leaves each tick enough slack to
+// keep publishing snapshots on cadence.
+const int TURBO_SPEEDS[] = {1, 10, 100, 0};
+const int TURBO_SPEED_COUNT = (int)(sizeof(TURBO_SPEEDS)/sizeof(TURBO_SPEEDS[0]));
+const float TURBO_TICK_BUDGET = 0.75f * SIM_DT;
 
-    // O
-    Matrix4 O0 = {{
-        {0,1,1,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}
-    }};
-    T[3].states = {O0};
-    T[3].colorId = 2;
-
-    // S
-    Matrix4 S0 = {{
-        {0,1,1,0}, {1,1,0,0}, {0,0,0,0}, {0,0,0,0}
-    }};
-    T[4].states = {S0, rotate90(S0)};
-    T[4].colorId = 6;
-
-    // T
-    Matrix4 T0m = {{
-        {0,1,0,0}, {1,1,1,0}, {0,0,0,0}, {0,0,0,0}
-    }};
-    for (int i=0;i<4;i++) {
-        if (i==0) T[5].states.push_back(T0m);
-        else T[5].states.push_back(rotate90(T[5].states.back()));
-    }
-    T[5].colorId = 3;
+// ==================== INPUT THREAD ====================
+// Manual play used to read the keyboard once per render frame and gate
+// all repeats on one shared timer, so players felt the 16ms poll
+// quantum, and with two keys held one key's repeat reset the other's
+// timer. Instead, a dedicated thread samples the key state at 1kHz and
+// pushes timestamped edge events into an SPSC ring; the sim drains the
+// ring each tick and runs a DAS/ARR repeat timer per key off the event
+// timestamps, so repeat cadence is millisecond-accurate and independent
+// per key.
+//
+// raylib's key-state table is written only by the main thread's event
+// pump, once per display frame; sampling it from another thread is a
+// race on single bytes (never torn), and it lets the sampler see the
+// pump's update as soon as it lands instead of after the frame has been
+// drawn and queued.
 
-    // Z
-    Matrix4 Z0 = {{
-        {1,1,0,0}, {0,1,1,0}, {0,0,0,0}, {0,0,0,0}
-    }};
-    T[6].states = {Z0, rotate90(Z0)};
-    T[6].colorId = 7;
+const float DAS_DELAY = 0.160f;   // held key: delay before auto-repeat
+const float ARR_DELAY = 0.040f;   // auto-repeat interval once DAS expires
 
-    return T;
-}
+// Logical gameplay keys; the sampler folds alternate bindings (UP/X).
+enum : uint8_t {
+    K_LEFT, K_RIGHT, K_SOFT_DROP,
+    K_ROT_CW, K_ROT_CCW, K_HARD_DROP, K_PAUSE,
+    K_COUNT
+};
 
-// ==================== PIECE STRUCTURE ====================
-struct Piece {
-    int type;
-    int x, y;
-    int rotation;
+// One key edge, stamped with profTicks() at the sample that saw it, so
+// press-to-apply latency can be measured on the same clock the profiler
+// uses.
+struct KeyEvent {
+    uint8_t key;
+    bool down;
+    uint64_t t;
 };
 
-// ==================== BOARD CLASS ====================
-class Board {
+// SPSC ring: the sampler thread pushes edges, the sim thread drains
+// everything pending at each tick. 256 slots is seconds of mashing; if
+// it ever fills (sim stalled) edges are dropped, and a stalled sim is
+// unplayable anyway.
+class KeyEventRing {
 public:
-    array<array<int, BOARD_W>, BOARD_H> cells{};
-
-    Board() {
-        for (auto &row : cells) row.fill(0);
+    bool push(const KeyEvent &e) {
+        unsigned h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == SIZE) return false;
+        slots[h % SIZE] = e;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(KeyEvent &e) {
+        unsigned t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        e = slots[t % SIZE];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
     }
+private:
+    static const unsigned SIZE = 256;
+    KeyEvent slots[SIZE];
+    std::atomic<unsigned> head{0}, tail{0};
+};
 
-    bool inBounds(int r, int c) const {
-        return r >= 0 && r < BOARD_H && c >= 0 && c < BOARD_W;
+// The 1kHz sampling thread. Pure edge detection: it keeps the previous
+// sample per logical key and only pushes changes, so the ring traffic is
+// a few events per keystroke, not a thousand samples a second.
+struct InputSampler {
+    KeyEventRing ring;
+    std::atomic<bool> running{true};
+    std::thread thread;
+
+    InputSampler() { thread = std::thread(&InputSampler::loop, this); }
+    ~InputSampler() {
+        running.store(false, std::memory_order_relaxed);
+        thread.join();
     }
 
-    bool collides(const Matrix4 &shape, int topR, int leftC) const {
-        for (int i=0;i<4;i++) {
-            for (int j=0;j<4;j++) {
-                if (!shape[i][j]) continue;
-                int r = topR + i;
-                int c = leftC + j;
-                if (c < 0 || c >= BOARD_W || r >= BOARD_H) return true;
-                if (r >= 0 && cells[r][c] != 0) return true;
-            }
+    static bool sampleKey(int k) {
+        switch (k) {
+            case K_LEFT:      return IsKeyDown(KEY_LEFT);
+            case K_RIGHT:     return IsKeyDown(KEY_RIGHT);
+            case K_SOFT_DROP: return IsKeyDown(KEY_DOWN);
+            case K_ROT_CW:    return IsKeyDown(KEY_UP) || IsKeyDown(KEY_X);
+            case K_ROT_CCW:   return IsKeyDown(KEY_Z);
+            case K_HARD_DROP: return IsKeyDown(KEY_SPACE);
+            case K_PAUSE:     return IsKeyDown(KEY_P);
         }
         return false;
     }
 
-    void placePiece(const Matrix4 &shape, int topR, int leftC, int colorId) {
-        for (int i=0;i<4;i++) {
-            for (int j=0;j<4;j++) {
-                if (shape[i][j]) {
-                    int r = topR + i;
-                    int c = leftC + j;
-                    if (r >= 0 && r < BOARD_H && c >= 0 && c < BOARD_W)
-                        cells[r][c] = colorId;
+    void loop() {
+        using clock = std::chrono::steady_clock;
+        const auto period = std::chrono::milliseconds(1);
+        bool down[K_COUNT] = {};
+        auto next = clock::now() + period;
+        while (running.load(std::memory_order_relaxed)) {
+            for (uint8_t k = 0; k < K_COUNT; ++k) {
+                bool d = sampleKey(k);
+                if (d != down[k]) {
+                    down[k] = d;
+                    ring.push({k, d, profTicks()});
                 }
             }
+            std::this_thread::sleep_until(next);
+            next += period;
         }
     }
+};
 
-    int clearLines() {
-        int cleared = 0;
-        for (int r = BOARD_H - 1; r >= 0; --r) {
-            bool full = true;
-            for (int c = 0; c < BOARD_W; ++c)
-                if (cells[r][c] == 0) { full = false; break; }
-            if (full) {
-                cleared++;
-                for (int rr = r; rr > 0; --rr)
-                    cells[rr] = cells[rr-1];
-                cells[0].fill(0);
-                r++;
-            }
-        }
-        return cleared;
-    }
+// Edge-triggered actions resolved for one sim tick.
+enum : uint8_t {
+    PRESS_ROT_CW    = 1,
+    PRESS_ROT_CCW   = 2,
+    PRESS_HARD_DROP = 4,
+    PRESS_PAUSE     = 8
+};
 
-    int dropPosition(const Matrix4 &shape, int leftC) const {
-        int topR = -4;
-        while (!collides(shape, topR + 1, leftC)) topR++;
-        if (collides(shape, topR, leftC)) return INT_MIN;
-        return topR;
-    }
+// One sim tick's worth of resolved input: movement steps the repeat
+// logic says to apply this tick, plus the edge-triggered presses.
+struct InputFrame {
+    bool left = false, right = false, down = false;
+    uint8_t pressed = 0;
+};
 
-    int columnHeight(int c) const {
-        for (int r = 0; r < BOARD_H; ++r)
-            if (cells[r][c] != 0) return BOARD_H - r;
-        return 0;
-    }
+// Per-key DAS/ARR state, owned by the sim thread. Converts the event
+// stream into per-tick commands: a press fires immediately and arms the
+// DAS timer; once DAS expires the key auto-repeats every ARR interval.
+// Timers run on the event timestamps, so when DAS expires relative to
+// the press is unaffected by tick alignment.
+struct KeyRepeat {
+    struct KeyState {
+        bool down = false;
+        uint64_t nextFire = 0;   // profTicks() time of the next auto-repeat
+    };
+    KeyState keys[K_COUNT];
 
-    int aggregateHeight() const {
-        int s = 0;
-        for (int c=0;c<BOARD_W;c++) s += columnHeight(c);
-        return s;
+    static void fire(InputFrame &f, int key) {
+        switch (key) {
+            case K_LEFT:      f.left = true; break;
+            case K_RIGHT:     f.right = true; break;
+            case K_SOFT_DROP: f.down = true; break;
+            case K_ROT_CW:    f.pressed |= PRESS_ROT_CW; break;
+            case K_ROT_CCW:   f.pressed |= PRESS_ROT_CCW; break;
+            case K_HARD_DROP: f.pressed |= PRESS_HARD_DROP; break;
+            case K_PAUSE:     f.pressed |= PRESS_PAUSE; break;
+        }
     }
 
-    int bumpiness() const {
-        int b = 0;
-        for (int c=0;c<BOARD_W-1;c++)
-            b += abs(columnHeight(c) - columnHeight(c+1));
-        return b;
-    }
+    InputFrame collect(KeyEventRing &ring) {
+        InputFrame f;
+        const double ticksPerNs = profTicksPerNs();
+        const uint64_t das = (uint64_t)(DAS_DELAY * 1e9 * ticksPerNs);
+        const uint64_t arr = (uint64_t)(ARR_DELAY * 1e9 * ticksPerNs);
 
-    int holes() const {
-        int h = 0;
-        for (int c=0;c<BOARD_W;c++) {
-            bool blockFound = false;
-            for (int r=0;r<BOARD_H;r++) {
-                if (cells[r][c] != 0) blockFound = true;
-                else if (blockFound) h++;
+        KeyEvent ev;
+        while (ring.pop(ev)) {
+            KeyState &k = keys[ev.key];
+            if (ev.down && !k.down) {
+                k.down = true;
+                k.nextFire = ev.t + das;
+                fire(f, ev.key);
+                profRings()[PROF_INPUT].record(profTicks() - ev.t);
+            } else if (!ev.down) {
+                k.down = false;
             }
         }
-        return h;
-    }
-};
-
-// ==================== AI DECISION ====================
-struct MoveDecision {
-    int rotationIndex;
-    int leftC;
-    double score;
-    int lines;
-};
 
-MoveDecision findBestMove(const Board &board, const vector<Tetromino> &tetrominoes, int pieceType) {
-    const Tetromino &piece = tetrominoes[pieceType];
-    MoveDecision best{0,0,-1e9,0};
-    
-    for (int rIdx = 0; rIdx < (int)piece.states.size(); ++rIdx) {
-        const Matrix4 &shape = piece.states[rIdx];
-        for (int left = -4; left <= BOARD_W; ++left) {
-            int top = board.dropPosition(shape, left);
-            if (top == INT_MIN) continue;
-            
-            Board b2 = board;
-            b2.placePiece(shape, top, left, piece.colorId);
-            int lines = b2.clearLines();
-
-            double score = 0.0;
-            score += W_LINES * lines;
-            score += W_HOLE * b2.holes();
-            score += W_HEIGHT * b2.aggregateHeight();
-            score += W_BUMPY * b2.bumpiness();
-
-            if (score > best.score) {
-                best = {rIdx, left, score, lines};
+        // Only the movement keys auto-repeat; rotation, hard drop and
+        // pause stay strictly edge-triggered.
+        uint64_t now = profTicks();
+        for (int k = K_LEFT; k <= K_SOFT_DROP; ++k) {
+            if (keys[k].down && now >= keys[k].nextFire) {
+                fire(f, k);
+                keys[k].nextFire += arr;
+                // A stalled sim doesn't burst a backlog of repeats.
+                if (keys[k].nextFire < now) keys[k].nextFire = now + arr;
             }
         }
+        return f;
     }
-    return best;
-}
+};
 
-// ==================== BAG RANDOMIZER ====================
-struct Bag {
-    vector<int> bag;
-    mt19937 rng;
-    
-    Bag() {
-        rng.seed(chrono::high_resolution_clock::now().time_since_epoch().count());
-        refill();
-    }
-    
-    void refill() {
-        bag.clear();
-        for (int i=0;i<7;i++) bag.push_back(i);
-        shuffle(bag.begin(), bag.end(), rng);
+// Everything the renderer needs for one frame, copied out of the Game by
+// the sim thread. ~3KB, copied at the sim rate, never shared mutable.
+struct RenderSnapshot {
+    Board board;
+    unsigned boardVersion = 0;
+    Piece cur{};
+    int ghostY = 0;     // landing row of cur (manual mode)
+    int turboMul = 1;   // active turbo multiplier (AI mode)
+    int score = 0;
+    int lines = 0;
+    int level = 1;
+    bool gameOver = false;
+    bool paused = false;
+    GameMode mode = MANUAL;
+};
+
+// Classic lock-free triple buffer. The writer always has a private slot
+// to fill and swaps it with the shared slot on publish; the reader swaps
+// its slot with the shared one only when the fresh bit says a new
+// snapshot landed since its last read. Neither side ever waits and the
+// reader always sees a complete snapshot.
+class SnapshotExchange {
+public:
+    RenderSnapshot &writeSlot() { return slots[writeIdx]; }
+    void publish() {
+        writeIdx = shared.exchange(writeIdx | FRESH_BIT,
+                                   std::memory_order_acq_rel) & INDEX_MASK;
     }
-    
-    int next() {
-        if (bag.empty()) refill();
-        int t = bag.back();
-        bag.pop_back();
-        return t;
+    // Latest published snapshot; keeps returning the previous one until
+    // something new is published.
+    const RenderSnapshot &read() {
+        if (shared.load(std::memory_order_acquire) & FRESH_BIT)
+            readIdx = shared.exchange(readIdx,
+                                      std::memory_order_acq_rel) & INDEX_MASK;
+        return slots[readIdx];
     }
+private:
+    static const int FRESH_BIT = 4;
+    static const int INDEX_MASK = 3;
+    RenderSnapshot slots[3];
+    std::atomic<int> shared{1};
+    int writeIdx = 0;
+    int readIdx = 2;
 };
 
 // ==================== GAME CLASS ====================
+// Monotonic stamp for settled-board changes; never reused across Game
+// instances so the render cache can't mistake a new game's board for a
+// previously painted one. Atomic because tournament mode locks pieces
+// from several sim threads at once.
+static std::atomic<unsigned> gBoardStamp{0};
+
+// Cell lookup for a rotated piece; pure table math, shared by the sim
+// thread (collision) and the render thread (drawing the falling piece).
+static int pieceCell(int type, int rotation, int i, int j) {
+    int idx = 0;
+    switch(rotation % 4){
+        case 0: idx = i*4 + j; break;
+        case 1: idx = (3 - j)*4 + i; break;
+        case 2: idx = (3 - i)*4 + (3 - j); break;
+        case 3: idx = j*4 + (3 - i); break;
+    }
+    return TETROMINO_CLASSIC[type][idx];
+}
+
 class Game {
 public:
     Board board;
     Piece cur;
+    int nextType;
     Bag bag;
+    unsigned boardVersion = ++gBoardStamp;
     int score = 0;
     int lines = 0;
     int level = 1;
     bool gameOver = false;
     bool paused = false;
-    vector<Tetromino> tetrominoes;
     GameMode mode;
     
     // For manual mode
     float gravityTimer = 0.0f;
     float gravityDelay = 0.8f;
-    float inputDelay = 0.08f;
-    float inputTimer = 0.0f;
-    bool leftHeld = false, rightHeld = false, downHeld = false;
     
     // For AI mode
     float aiTimer = 0.0f;
     float aiCooldown = 1.08f;
-    
-    Game(GameMode gm) : mode(gm) {
-        tetrominoes = makeTetrominoes();
+    // Search for the piece spawned most recently, computed on a worker
+    // while the cooldown runs; updateAI only collects the result.
+    // Tournament games search synchronously on their own sim thread
+    // instead (shared-nothing, so 64 boards scale across cores).
+    bool asyncAI;
+    future<MoveDecision> pendingMove;
+    // Beam preset; depth 0 means the two-ply lookahead.
+    int beamDepth, beamWidth;
+    long long beamBudget;
+
+    // Turbo multiplier (see TURBO_SPEEDS); owned by the sim thread,
+    // mirrored from SimSession::turbo each tick.
+    int turboMul = 1;
+
+    // Ghost piece cache: landing row plus the piece/board state it was
+    // computed for (see ghostRow).
+    int ghostY = 0;
+    int ghostKeyX = INT_MIN, ghostKeyRot = -1, ghostKeyType = -1;
+    unsigned ghostKeyBoard = 0;
+
+    // seeded selects the reproducible Bag constructor; otherwise the bag
+    // seeds itself from the clock as always.
+    Game(GameMode gm, bool asyncSearch = true,
+         int beamD = 0, int beamW = 0, long long beamB = 0,
+         uint64_t seed = 0, bool seeded = false)
+        : bag(seeded ? Bag(seed) : Bag()), mode(gm), asyncAI(asyncSearch),
+          beamDepth(beamD), beamWidth(beamW), beamBudget(beamB) {
+        nextType = bag.next();
         spawnPiece();
     }
-    
+
+    // Upcoming pieces the search may assume: current, next, then the
+    // bag preview. Returns how many of seq were filled (= search depth).
+    int upcomingPieces(array<int,16> &seq) {
+        int d = min(beamDepth, 16);
+        seq[0] = cur.type;
+        if (d > 1) seq[1] = nextType;
+        for (int i = 2; i < d; ++i)
+            seq[i] = bag.peek(i - 2);
+        return d;
+    }
+
     void spawnPiece() {
-        cur.type = bag.next();
+        cur.type = nextType;
+        nextType = bag.next();
         cur.rotation = 0;
         cur.x = (BOARD_W/2) - 2;
         cur.y = 0;
         if (collidesPiece(cur.x, cur.y, cur.type, cur.rotation)) {
             gameOver = true;
         }
-    }
-    
-    int pieceCell(int type, int rotation, int i, int j) const {
-        int idx = 0;
-        switch(rotation % 4){
-            case 0: idx = i*4 + j; break;
-            case 1: idx = (3 - j)*4 + i; break;
-            case 2: idx = (3 - i)*4 + (3 - j); break;
-            case 3: idx = j*4 + (3 - i); break;
+        // Board and piece are fixed from spawn until placement, so the
+        // whole aiCooldown window is free compute time: kick the search
+        // off now instead of paying for it when the cooldown elapses.
+        // Turbo places back to back, where a task launch per piece would
+        // cost more than the search; it runs synchronously instead.
+        if (mode != MANUAL && asyncAI && turboMul == 1 && !gameOver) {
+            BitBoard bb(board);
+            if (beamDepth > 1) {
+                array<int,16> seq{};
+                int d = upcomingPieces(seq);
+                int bw = beamWidth;
+                long long budget = beamBudget;
+                pendingMove = async(launch::async, [bb, seq, d, bw, budget] {
+                    ProfScope prof(PROF_SEARCH);
+                    return findBestMoveBeam(bb, seq.data(), d, bw, budget);
+                });
+            } else {
+                int curT = cur.type, nextT = nextType;
+                pendingMove = async(launch::async, [bb, curT, nextT] {
+                    ProfScope prof(PROF_SEARCH);
+                    return findBestMoveLookahead(bb, curT, nextT, &aiThreadPool());
+                });
+            }
         }
-        return TETROMINO_CLASSIC[type][idx];
     }
     
     bool collidesPiece(int px, int py, int type, int rotation) const {
@@ -397,10 +502,18 @@ public:
             }
         }
         clearLines();
+        markBoardDirty();
         spawnPiece();
     }
-    
+
+    // The settled board only changes here and in updateAI's placement;
+    // the renderer repaints its cached texture when the stamp moves.
+    void markBoardDirty() {
+        boardVersion = ++gBoardStamp;
+    }
+
     void clearLines(){
+        ProfScope prof(PROF_CLEAR);
         int cleared = board.clearLines();
         if(cleared > 0){
             lines += cleared;
@@ -410,79 +523,125 @@ public:
         }
     }
     
+    // Landing row of the current piece: the y it would settle at if
+    // dropped straight down. The descent runs collidesPiece once per row,
+    // so the result is cached and refreshed only when the piece moves
+    // sideways, rotates, changes, or the settled board does — a few
+    // times a second, while the renderer asks for it every snapshot.
+    // (The landing row does not depend on cur.y: the piece only ever
+    // falls straight down, so soft drop and gravity keep the cache valid.)
+    int ghostRow() {
+        if (cur.x != ghostKeyX || cur.rotation != ghostKeyRot ||
+            cur.type != ghostKeyType || boardVersion != ghostKeyBoard) {
+            ghostKeyX = cur.x;
+            ghostKeyRot = cur.rotation;
+            ghostKeyType = cur.type;
+            ghostKeyBoard = boardVersion;
+            int y = cur.y;
+            while (!collidesPiece(cur.x, y + 1, cur.type, cur.rotation)) y++;
+            ghostY = y;
+        }
+        return ghostY;
+    }
+
     void hardDrop(){
-        while(!collidesPiece(cur.x, cur.y+1, cur.type, cur.rotation)) cur.y++;
+        cur.y = ghostRow();   // same descent the ghost already cached
         lockPiece();
     }
     
-    void updateAI(float dt) {
-        if(gameOver) return;
-        
-        aiTimer += dt;
-        if(aiTimer >= aiCooldown) {
-            aiTimer = 0.0f;
-            MoveDecision move = findBestMove(board, tetrominoes, cur.type);
-            
-            if(move.score < -1e8) {
+    // One complete AI placement: search, place, score, spawn. Shared by
+    // the paced path and the turbo loop below.
+    void placeAIMove() {
+        // Two-ply search: submitted at spawn time and collected here,
+        // or run in place on this game's own sim thread in tournament
+        // mode (the per-thread eval cache keeps it a few microseconds).
+        MoveDecision move;
+        if (pendingMove.valid()) {
+            move = pendingMove.get();
+        } else if (beamDepth > 1) {
+            ProfScope searchProf(PROF_SEARCH);
+            array<int,16> seq{};
+            int d = upcomingPieces(seq);
+            move = findBestMoveBeam(BitBoard(board), seq.data(), d, beamWidth, beamBudget);
+        } else {
+            ProfScope searchProf(PROF_SEARCH);
+            move = findBestMoveLookahead(BitBoard(board), cur.type, nextType);
+        }
+
+        if(move.score < -1e8) {
+            gameOver = true;
+        } else {
+            // Use the constexpr rotation matrix to place the piece directly
+            const Matrix4 &shape = TETROMINO_STATES[cur.type][move.rotationIndex];
+            int top = board.dropPosition(shape, move.leftC);
+            if (top == INT_MIN) {
                 gameOver = true;
             } else {
-                // Use the Tetromino matrix to place the piece directly on the board
-                const Matrix4 &shape = tetrominoes[cur.type].states[move.rotationIndex];
-                int top = board.dropPosition(shape, move.leftC);
-                if (top == INT_MIN) {
-                    gameOver = true;
-                } else {
-                    // Place and score like original tetris.cpp
-                    board.placePiece(shape, top, move.leftC, tetrominoes[cur.type].colorId);
-                    int cleared = board.clearLines();
-                    if (cleared > 0) {
-                        lines += cleared;
-                        // original scoring: 100 * (2^(lines-1)) per clear-set
-                        score += 100 * (1 << (cleared - 1));
-                        level = 1 + lines / 10;
-                    }
-                    // Spawn next piece (spawnPiece uses bag.next())
-                    spawnPiece();
+                // Place and score like original tetris.cpp
+                board.placePiece(shape, top, move.leftC, TETROMINO_COLOR[cur.type]);
+                int cleared = board.clearLines();
+                if (cleared > 0) {
+                    lines += cleared;
+                    // original scoring: 100 * (2^(lines-1)) per clear-set
+                    score += 100 * (1 << (cleared - 1));
+                    level = 1 + lines / 10;
                 }
+                markBoardDirty();
+                // Spawn next piece (spawnPiece uses bag.next())
+                spawnPiece();
             }
         }
     }
+
+    void updateAI(float dt) {
+        if(gameOver) return;
+        ProfScope prof(PROF_UPDATE_AI);
+
+        // Unlimited turbo: placements are bounded only by a per-tick time
+        // budget, so the rate is whatever the search sustains. The sim
+        // keeps its tick cadence (the budget leaves slack in each tick)
+        // and the renderer just shows whichever board each snapshot
+        // carries, so the window stays responsive throughout.
+        if (turboMul == 0) {
+            const uint64_t budget =
+                (uint64_t)(TURBO_TICK_BUDGET * 1e9 * profTicksPerNs());
+            uint64_t start = profTicks();
+            while (!gameOver && profTicks() - start < budget)
+                placeAIMove();
+            return;
+        }
+
+        // Paced path; turbo multipliers just run the cooldown clock
+        // faster (capped at one placement per sim tick).
+        aiTimer += dt * turboMul;
+        if(aiTimer >= aiCooldown) {
+            aiTimer = 0.0f;
+            placeAIMove();
+        }
+    }
     
-    void updateManual(float dt) {
+    // `in` is already repeat-resolved by KeyRepeat: a set movement flag
+    // means "apply one step this tick", so there is no held/timer state
+    // here anymore.
+    void updateManual(float dt, const InputFrame &in) {
+        if((in.pressed & PRESS_PAUSE) && !gameOver) paused = !paused;
         if(gameOver || paused) return;
-        
+        ProfScope prof(PROF_UPDATE_MANUAL);
+
         gravityDelay = max(0.05f, 0.8f - (level-1)*0.05f);
         gravityTimer += dt;
-        inputTimer += dt;
-
-        if(IsKeyDown(KEY_LEFT)){
-            if(!leftHeld || inputTimer >= inputDelay){
-                if(!collidesPiece(cur.x - 1, cur.y, cur.type, cur.rotation)){
-                    cur.x -= 1;
-                }
-                leftHeld = true; inputTimer = 0;
-            }
-        } else leftHeld = false;
 
-        if(IsKeyDown(KEY_RIGHT)){
-            if(!rightHeld || inputTimer >= inputDelay){
-                if(!collidesPiece(cur.x + 1, cur.y, cur.type, cur.rotation)){
-                    cur.x += 1;
-                }
-                rightHeld = true; inputTimer = 0;
-            }
-        } else rightHeld = false;
-
-        if(IsKeyDown(KEY_DOWN)){
-            if(!downHeld || inputTimer >= inputDelay){
-                if(!collidesPiece(cur.x, cur.y+1, cur.type, cur.rotation)){
-                    cur.y += 1;
-                }
-                downHeld = true; inputTimer = 0;
-            }
-        } else downHeld = false;
+        if(in.left && !collidesPiece(cur.x - 1, cur.y, cur.type, cur.rotation)){
+            cur.x -= 1;
+        }
+        if(in.right && !collidesPiece(cur.x + 1, cur.y, cur.type, cur.rotation)){
+            cur.x += 1;
+        }
+        if(in.down && !collidesPiece(cur.x, cur.y+1, cur.type, cur.rotation)){
+            cur.y += 1;
+        }
 
-        if(IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_X)){
+        if(in.pressed & PRESS_ROT_CW){
             int newRot = (cur.rotation + 1) % 4;
             if(!collidesPiece(cur.x, cur.y, cur.type, newRot)){
                 cur.rotation = newRot;
@@ -492,7 +651,7 @@ public:
             }
         }
         
-        if(IsKeyPressed(KEY_Z)){
+        if(in.pressed & PRESS_ROT_CCW){
             int newRot = (cur.rotation + 3) % 4;
             if(!collidesPiece(cur.x, cur.y, cur.type, newRot)){
                 cur.rotation = newRot;
@@ -502,7 +661,7 @@ public:
             }
         }
 
-        if(IsKeyPressed(KEY_SPACE)){
+        if(in.pressed & PRESS_HARD_DROP){
             hardDrop();
             gravityTimer = 0;
         }
@@ -518,82 +677,392 @@ public:
     }
 };
 
+// ==================== SNAPSHOT SAVE / RESUME ====================
+// Kiosk deployments restart the process on a watchdog timer; a compact
+// binary snapshot of the running Game lets the restarted process land
+// straight back on the playing board instead of replaying the menu
+// flow. One fixed-size record (~300 bytes): scalar game state, bag
+// contents plus xoshiro state, then one byte per board cell. Writes go
+// to <path>.tmp and rename() into place, so a kill mid-write never
+// leaves a torn file. POSIX only, like the replay format.
+
+struct GameSave {
+    uint8_t mode = MANUAL;        // GameMode; tournaments are not saved
+    uint8_t aiPreset = 0;
+    uint8_t paused = 0;
+    uint8_t gameOver = 0;
+    int32_t curType = 0, curX = 0, curY = 0, curRot = 0;
+    int32_t nextType = 0;
+    int32_t score = 0, lines = 0, level = 1;
+    float gravityTimer = 0.0f, aiTimer = 0.0f;
+    uint64_t rng[4] = {};
+    uint8_t bagCount = 0;
+    uint8_t bagVals[32] = {};     // Bag::peek can grow the queue past one bag
+    uint8_t cells[BOARD_H][BOARD_W] = {};
+};
+
+struct SaveHeader {
+    char magic[4];      // "TSAV"
+    uint32_t version;   // 1
+};
+
+static void captureSave(const Game &g, int aiPreset, GameSave &s) {
+    s.mode = (uint8_t)g.mode;
+    s.aiPreset = (uint8_t)aiPreset;
+    s.paused = g.paused;
+    s.gameOver = g.gameOver;
+    s.curType = g.cur.type; s.curX = g.cur.x;
+    s.curY = g.cur.y; s.curRot = g.cur.rotation;
+    s.nextType = g.nextType;
+    s.score = g.score; s.lines = g.lines; s.level = g.level;
+    s.gravityTimer = g.gravityTimer;
+    s.aiTimer = g.aiTimer;
+    auto st = g.bag.rng.state();
+    for (int i = 0; i < 4; ++i) s.rng[i] = st[i];
+    s.bagCount = (uint8_t)min(g.bag.bag.size(), sizeof s.bagVals);
+    for (int i = 0; i < s.bagCount; ++i) s.bagVals[i] = (uint8_t)g.bag.bag[i];
+    for (int r = 0; r < BOARD_H; ++r)
+        for (int c = 0; c < BOARD_W; ++c)
+            s.cells[r][c] = (uint8_t)g.board.cells[r][c];
+}
+
+// Overwrites a freshly constructed Game. The constructor already drew
+// spawn pieces and (in AI mode) submitted a search for them; the search
+// saw a different board, so the pending future is dropped and updateAI
+// falls back to its synchronous path for the restored piece.
+static void applySave(const GameSave &s, Game &g) {
+    for (int r = 0; r < BOARD_H; ++r)
+        for (int c = 0; c < BOARD_W; ++c)
+            g.board.cells[r][c] = s.cells[r][c];
+    g.cur = {s.curType, s.curX, s.curY, s.curRot};
+    g.nextType = s.nextType;
+    g.bag.bag.assign(s.bagVals, s.bagVals + s.bagCount);
+    g.bag.rng.setState({s.rng[0], s.rng[1], s.rng[2], s.rng[3]});
+    g.score = s.score; g.lines = s.lines; g.level = s.level;
+    g.paused = s.paused;
+    g.gameOver = s.gameOver;
+    g.gravityTimer = s.gravityTimer;
+    g.aiTimer = s.aiTimer;
+    g.pendingMove = future<MoveDecision>();
+    g.markBoardDirty();
+}
+
+static bool writeSave(const char *path, const GameSave &s) {
+    char tmp[512];
+    snprintf(tmp, sizeof tmp, "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return false;
+    SaveHeader h{};
+    memcpy(h.magic, "TSAV", 4);
+    h.version = 1;
+    bool ok = fwrite(&h, sizeof h, 1, f) == 1 &&
+              fwrite(&s, sizeof s, 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    if (ok) ok = rename(tmp, path) == 0;
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+static bool readSave(const char *path, GameSave &s) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    SaveHeader h{};
+    bool ok = fread(&h, sizeof h, 1, f) == 1 &&
+              memcmp(h.magic, "TSAV", 4) == 0 && h.version == 1 &&
+              fread(&s, sizeof s, 1, f) == 1;
+    fclose(f);
+    // Range-check every field applySave feeds into a table lookup: this
+    // is the watchdog-restart path, exactly where truncated or garbage
+    // files show up, and a well-formed header does not make the payload
+    // sane. A bad record falls back to the menu flow.
+    if (!ok || s.mode > TOURNAMENT || s.aiPreset >= AI_PRESET_COUNT ||
+        s.bagCount > sizeof s.bagVals)
+        return false;
+    if (s.curType < 0 || s.curType > 6 || s.nextType < 0 || s.nextType > 6 ||
+        s.curRot < 0 || s.curRot > 3)
+        return false;
+    for (int i = 0; i < s.bagCount; ++i)
+        if (s.bagVals[i] > 6) return false;
+    for (int r = 0; r < BOARD_H; ++r)
+        for (int c = 0; c < BOARD_W; ++c)
+            if (s.cells[r][c] > 7) return false;
+    return true;
+}
+
+// ==================== SIMULATION SESSION ====================
+// Owns a Game for one round, the 1kHz input sampler, and the thread that
+// advances the game. The sim thread ticks at SIM_DT regardless of render
+// framerate: each tick it drains the sampler's key events through the
+// DAS/ARR tracker, steps the game, and publishes a snapshot. Stopping is
+// a flag + join, so tearing a session down from the main loop is safe.
+// With a save path the session snapshots the game periodically and on
+// teardown; a finished game removes the file instead, so the next
+// restart starts clean.
+struct SimSession {
+    Game game;
+    SnapshotExchange snapshots;
+    InputSampler sampler;
+    KeyRepeat repeat;
+    std::atomic<bool> running{true};
+    std::thread thread;
+    const char *savePath;   // nullptr: no snapshots
+    int presetIdx;
+    long long tickCount = 0;
+    // Turbo multiplier, written by the main loop's hotkey and mirrored
+    // into the Game by the sim thread each tick.
+    std::atomic<int> turbo{1};
+
+    SimSession(GameMode gm, const AiPreset &p,
+               uint64_t seed = 0, bool seeded = false,
+               int presetIdx = 0, const char *savePath = nullptr,
+               const GameSave *resume = nullptr)
+        : game(gm, true, p.depth, p.width, p.budget, seed, seeded),
+          savePath(savePath), presetIdx(presetIdx) {
+        if (resume) applySave(*resume, game);
+        publishSnapshot();   // renderer has a valid frame before the thread spins up
+        thread = std::thread(&SimSession::simLoop, this);
+    }
+
+    ~SimSession() {
+        running.store(false, std::memory_order_relaxed);
+        thread.join();
+        if (savePath) {
+            // A finished game is not worth resuming into; clear the file
+            // so the next launch goes through the menus.
+            if (game.gameOver) remove(savePath);
+            else saveNow();
+        }
+    }
+
+    void saveNow() {
+        GameSave s;
+        captureSave(game, presetIdx, s);
+        writeSave(savePath, s);
+    }
+
+    void publishSnapshot() {
+        RenderSnapshot &s = snapshots.writeSlot();
+        s.board = game.board;
+        s.boardVersion = game.boardVersion;
+        s.cur = game.cur;
+        // Usually a cache hit; the descent only reruns after the piece
+        // or board actually changed.
+        s.ghostY = (game.mode == MANUAL && !game.gameOver) ? game.ghostRow()
+                                                          : game.cur.y;
+        s.turboMul = game.turboMul;
+        s.score = game.score;
+        s.lines = game.lines;
+        s.level = game.level;
+        s.gameOver = game.gameOver;
+        s.paused = game.paused;
+        s.mode = game.mode;
+        snapshots.publish();
+    }
+
+    void simLoop() {
+        using clock = std::chrono::steady_clock;
+        const auto tick = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<float>(SIM_DT));
+        auto next = clock::now() + tick;
+        while (running.load(std::memory_order_relaxed)) {
+            game.turboMul = turbo.load(std::memory_order_relaxed);
+            InputFrame in = repeat.collect(sampler.ring);
+            if (game.mode == MANUAL) {
+                game.updateManual(SIM_DT, in);
+            } else {
+                game.updateAI(SIM_DT);
+            }
+            publishSnapshot();
+            // Periodic crash insurance: ~every 5s at the sim rate. The
+            // sim thread owns the Game, so no locking is needed, and the
+            // tmp+rename in writeSave keeps the file always readable.
+            if (savePath && ++tickCount % 600 == 0 && !game.gameOver)
+                saveNow();
+            std::this_thread::sleep_until(next);
+            next += tick;
+        }
+    }
+};
+
+// ==================== TOURNAMENT SESSION ====================
+// N independent AI games advanced by one sim thread per core. Shared-
+// nothing by construction: each thread owns a fixed shard of games,
+// every game has its own Board, Bag, search state, and snapshot
+// exchange, and the only cross-thread traffic is the render thread
+// reading snapshots. Scaling is therefore linear in cores until the
+// machine runs out of them.
+struct TournamentSession {
+    struct Entry {
+        Game game;
+        SnapshotExchange snapshots;
+        Entry(uint64_t seed, bool seeded)
+            : game(TOURNAMENT, /*asyncSearch=*/false, 0, 0, 0, seed, seeded) {
+            game.aiCooldown = TOURNEY_COOLDOWN;
+        }
+    };
+
+    vector<unique_ptr<Entry>> entries;
+    vector<std::thread> threads;
+    std::atomic<bool> running{true};
+
+    // With a seed, game i plays seed+i, so a tournament is replayable
+    // end to end.
+    explicit TournamentSession(int n, uint64_t seed = 0, bool seeded = false) {
+        for (int i = 0; i < n; ++i) {
+            entries.emplace_back(new Entry(seed + i, seeded));
+            publishSnapshot(*entries.back());
+        }
+        int cores = (int)std::thread::hardware_concurrency();
+        if (cores < 1) cores = 1;
+        int nthreads = min(cores, n);
+        for (int t = 0; t < nthreads; ++t)
+            threads.emplace_back(&TournamentSession::shardLoop, this, t, nthreads);
+    }
+
+    ~TournamentSession() {
+        running.store(false, std::memory_order_relaxed);
+        for (auto &t : threads) t.join();
+    }
+
+    static void publishSnapshot(Entry &e) {
+        RenderSnapshot &s = e.snapshots.writeSlot();
+        s.board = e.game.board;
+        s.boardVersion = e.game.boardVersion;
+        s.cur = e.game.cur;
+        s.score = e.game.score;
+        s.lines = e.game.lines;
+        s.level = e.game.level;
+        s.gameOver = e.game.gameOver;
+        s.paused = false;
+        s.mode = TOURNAMENT;
+        e.snapshots.publish();
+    }
+
+    void shardLoop(int shard, int nthreads) {
+        using clock = std::chrono::steady_clock;
+        const auto tick = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<float>(SIM_DT));
+        auto next = clock::now() + tick;
+        while (running.load(std::memory_order_relaxed)) {
+            for (size_t i = shard; i < entries.size(); i += nthreads) {
+                Entry &e = *entries[i];
+                if (!e.game.gameOver) {
+                    e.game.updateAI(SIM_DT);
+                    publishSnapshot(e);
+                }
+            }
+            std::this_thread::sleep_until(next);
+            next += tick;
+        }
+    }
+};
+
 // ==================== RENDERING ====================
+// Text layout caching: the menus and sidebar draw the same constant
+// strings every frame, and MeasureText walks the glyph table each call.
+// Constant strings are measured once (keyed by literal pointer, which is
+// stable), dynamic strings are re-formatted only when their value
+// changes, and the static instruction block is pre-rendered to a texture
+// drawn with one call.
+static int MeasureLiteral(const char *s, int size) {
+    struct Entry { const char *s; int size; int w; };
+    static Entry cache[48];
+    static int n = 0;
+    for (int i = 0; i < n; ++i)
+        if (cache[i].s == s && cache[i].size == size) return cache[i].w;
+    int w = MeasureText(s, size);
+    if (n < 48) cache[n++] = {s, size, w};
+    return w;
+}
+
 void DrawMainMenu(int& selectedOption, float animTime) {
     ClearBackground(Color{20, 20, 40, 255});
-    
+
     const char* title = "TETRIS";
     int titleSize = 80;
-    int titleWidth = MeasureText(title, titleSize);
+    int titleWidth = MeasureLiteral(title, titleSize);
     int titleY = 120 + (int)(sin(animTime * 2) * 5);
-    
+
     DrawText(title, WINDOW_W/2 - titleWidth/2 + 4, titleY + 4, titleSize, Fade(BLACK, 0.5f));
     DrawText(title, WINDOW_W/2 - titleWidth/2, titleY, titleSize, SKYBLUE);
-    
-    vector<string> options = {"Start Game", "Instructions", "Quit"};
+
+    static const char* const options[] = {"Start Game", "Instructions", "Quit"};
     int startY = 320;
     int spacing = 80;
-    
-    for(size_t i = 0; i < options.size(); i++) {
+
+    for(size_t i = 0; i < 3; i++) {
         int optionY = startY + i * spacing;
-        int textWidth = MeasureText(options[i].c_str(), 30);
+        int textWidth = MeasureLiteral(options[i], 30);
         int textX = WINDOW_W/2 - textWidth/2;
-        
+
         bool isSelected = (selectedOption == (int)i);
         Color textColor = isSelected ? YELLOW : WHITE;
-        
+
         if(isSelected) {
             DrawRectangle(textX - 20, optionY - 10, textWidth + 40, 50, Fade(SKYBLUE, 0.3f));
             DrawText(">", textX - 50, optionY, 30, YELLOW);
         }
-        
-        DrawText(options[i].c_str(), textX, optionY, 30, textColor);
+
+        DrawText(options[i], textX, optionY, 30, textColor);
     }
-    
-    DrawText("Use UP/DOWN arrows and ENTER to select", WINDOW_W/2 - MeasureText("Use UP/DOWN arrows and ENTER to select", 16)/2, 
+
+    DrawText("Use UP/DOWN arrows and ENTER to select", WINDOW_W/2 - MeasureLiteral("Use UP/DOWN arrows and ENTER to select", 16)/2,
              WINDOW_H - 80, 16, LIGHTGRAY);
 }
 
-void DrawModeSelect(int& selectedMode) {
+void DrawModeSelect(int& selectedMode, int aiPreset) {
     ClearBackground(Color{20, 20, 40, 255});
     
     const char* title = "SELECT GAME MODE";
-    int titleWidth = MeasureText(title, 40);
+    int titleWidth = MeasureLiteral(title, 40);
     DrawText(title, WINDOW_W/2 - titleWidth/2, 100, 40, SKYBLUE);
-    
-    vector<string> modes = {"Manual (Player Controlled)", "AI (Automatic Placement)"};
-    int startY = 280;
-    int spacing = 120;
-    
-    for(size_t i = 0; i < modes.size(); i++) {
+
+    static const char* const modes[] = {"Manual (Player Controlled)", "AI (Automatic Placement)",
+                                        "Tournament (64 AI Boards)"};
+    int startY = 240;
+    int spacing = 110;
+
+    for(size_t i = 0; i < 3; i++) {
         int modeY = startY + i * spacing;
-        int textWidth = MeasureText(modes[i].c_str(), 28);
+        int textWidth = MeasureLiteral(modes[i], 28);
         int textX = WINDOW_W/2 - textWidth/2;
-        
+
         bool isSelected = (selectedMode == (int)i);
         Color textColor = isSelected ? YELLOW : WHITE;
-        
+
         if(isSelected) {
             DrawRectangle(textX - 30, modeY - 15, textWidth + 60, 60, Fade(SKYBLUE, 0.3f));
             DrawText(">", textX - 60, modeY, 28, YELLOW);
         }
-        
-        DrawText(modes[i].c_str(), textX, modeY, 28, textColor);
+
+        DrawText(modes[i], textX, modeY, 28, textColor);
+
+        // The AI entry also picks the search engine; the preset name is
+        // a literal from AI_PRESETS, so its width caches too.
+        if(i == 1) {
+            const char* presetName = AI_PRESETS[aiPreset].name;
+            Color presetColor = isSelected ? SKYBLUE : GRAY;
+            int w = MeasureLiteral("search: ", 16) + MeasureLiteral(presetName, 16);
+            int x = WINDOW_W/2 - w/2;
+            DrawText("search: ", x, modeY + 38, 16, presetColor);
+            DrawText(presetName, x + MeasureLiteral("search: ", 16), modeY + 38, 16, presetColor);
+        }
     }
-    
-    DrawText("Use UP/DOWN arrows and ENTER to select", WINDOW_W/2 - MeasureText("Use UP/DOWN arrows and ENTER to select", 14)/2, 
+
+    DrawText("UP/DOWN + ENTER to select, LEFT/RIGHT: AI search preset",
+             WINDOW_W/2 - MeasureLiteral("UP/DOWN + ENTER to select, LEFT/RIGHT: AI search preset", 14)/2,
              WINDOW_H - 60, 14, LIGHTGRAY);
 }
 
 void DrawInstructions(bool& showInstructions) {
     ClearBackground(Color{20, 20, 40, 255});
     
-    DrawText("INSTRUCTIONS", WINDOW_W/2 - MeasureText("INSTRUCTIONS", 40)/2, 60, 40, SKYBLUE);
-    
+    DrawText("INSTRUCTIONS", WINDOW_W/2 - MeasureLiteral("INSTRUCTIONS", 40)/2, 60, 40, SKYBLUE);
+
     int startY = 140;
     int lineHeight = 35;
-    
-    vector<pair<string, string>> instructions = {
+
+    static const char* const instructions[][2] = {
         {"LEFT/RIGHT", "Move piece"},
         {"DOWN", "Soft drop"},
         {"UP or X", "Rotate clockwise"},
@@ -602,109 +1071,466 @@ void DrawInstructions(bool& showInstructions) {
         {"P", "Pause game"},
         {"ESC", "Return to menu"}
     };
-    
-    for(size_t i = 0; i < instructions.size(); i++) {
+
+    for(size_t i = 0; i < 7; i++) {
         int y = startY + i * lineHeight;
-        DrawText(instructions[i].first.c_str(), 120, y, 20, YELLOW);
+        DrawText(instructions[i][0], 120, y, 20, YELLOW);
         DrawText("-", 280, y, 20, WHITE);
-        DrawText(instructions[i].second.c_str(), 310, y, 20, WHITE);
+        DrawText(instructions[i][1], 310, y, 20, WHITE);
     }
-    
+
     DrawText("OBJECTIVE:", 120, startY + 280, 24, SKYBLUE);
     DrawText("Clear lines by filling rows completely.", 120, startY + 315, 18, LIGHTGRAY);
     DrawText("Game speeds up every 10 lines.", 120, startY + 345, 18, LIGHTGRAY);
     DrawText("Don't let blocks reach the top!", 120, startY + 375, 18, LIGHTGRAY);
     
-    DrawText("Press ENTER to return to menu", WINDOW_W/2 - MeasureText("Press ENTER to return to menu", 18)/2, 
+    DrawText("Press ENTER to return to menu", WINDOW_W/2 - MeasureLiteral("Press ENTER to return to menu", 18)/2,
              WINDOW_H - 60, 18, YELLOW);
 }
 
-void DrawGameScreen(Game& game) {
+// The seven control hints never change: render them into a texture once
+// and blit with a single draw call per frame.
+static void DrawControlsCached(int x, int y) {
+    static RenderTexture2D cache{};
+    const int w = 140, h = 110;
+
+    if (cache.id == 0) {
+        cache = LoadRenderTexture(w, h);
+        BeginTextureMode(cache);
+        ClearBackground(BLANK);
+        DrawText("Controls (Manual):", 0, 0, 12, SKYBLUE);
+        DrawText("Arrows: Move/Drop", 0, 20, 10, WHITE);
+        DrawText("Up/X: Rotate CW", 0, 35, 10, WHITE);
+        DrawText("Z: Rotate CCW", 0, 50, 10, WHITE);
+        DrawText("Space: Hard Drop", 0, 65, 10, WHITE);
+        DrawText("P: Pause", 0, 80, 10, WHITE);
+        DrawText("ESC: Menu", 0, 95, 10, WHITE);
+        EndTextureMode();
+    }
+
+    DrawTextureRec(cache.texture, Rectangle{0, 0, (float)w, (float)-h},
+                   Vector2{(float)x, (float)y}, WHITE);
+}
+
+// Settled board + grid lines rendered once into a texture and blitted
+// with a single draw call per frame. The board only changes when a piece
+// locks or lines clear (a few times per second at most), while the full
+// per-cell redraw was ~200 rectangles plus 32 grid lines at 60fps.
+static void DrawBoardCached(const RenderSnapshot& snap, int boardX, int boardY) {
+    static RenderTexture2D cache{};
+    static unsigned paintedVersion = 0;
+
+    if (cache.id == 0)
+        cache = LoadRenderTexture(BOARD_W*CELL, BOARD_H*CELL);
+
+    if (paintedVersion != snap.boardVersion) {
+        paintedVersion = snap.boardVersion;
+        BeginTextureMode(cache);
+        ClearBackground(LIGHTGRAY);
+        for(int r=0;r<BOARD_H;r++){
+            for(int c=0;c<BOARD_W;c++){
+                int v = snap.board.cells[r][c];
+                if(v){
+                    DrawRectangle(c*CELL, r*CELL, CELL-2, CELL-2, PALETTE[v]);
+                }
+            }
+        }
+        for(int i=0;i<=BOARD_W;i++) DrawLine(i*CELL, 0, i*CELL, BOARD_H*CELL, Fade(BLACK,0.12f));
+        for(int i=0;i<=BOARD_H;i++) DrawLine(0, i*CELL, BOARD_W*CELL, i*CELL, Fade(BLACK,0.12f));
+        EndTextureMode();
+    }
+
+    // Render textures are y-flipped, hence the negative source height.
+    DrawTextureRec(cache.texture,
+                   Rectangle{0, 0, (float)(BOARD_W*CELL), (float)(-BOARD_H*CELL)},
+                   Vector2{(float)boardX, (float)boardY}, WHITE);
+}
+
+void DrawGameScreen(const RenderSnapshot& snap) {
+    ProfScope prof(PROF_DRAW);
     ClearBackground(BLACK);
 
     int boardX = 20, boardY = 20;
     DrawRectangle(boardX-4, boardY-4, BOARD_W*CELL+8, BOARD_H*CELL+8, DARKGRAY);
-    DrawRectangle(boardX, boardY, BOARD_W*CELL, BOARD_H*CELL, LIGHTGRAY);
-
-    // Draw board
-    for(int r=0;r<BOARD_H;r++){
-        for(int c=0;c<BOARD_W;c++){
-            int v = game.board.cells[r][c];
-            if(v){
-                DrawRectangle(boardX + c*CELL, boardY + r*CELL, CELL-2, CELL-2, PALETTE[v]);
+
+    DrawBoardCached(snap, boardX, boardY);
+
+    // Only the falling piece (and its ghost) is drawn immediate-mode on top
+    if(!snap.gameOver){
+        // Ghost: outline of the piece at its landing row, so the stack
+        // underneath stays readable. Skipped when the piece is already
+        // resting there.
+        if(snap.mode == MANUAL && snap.ghostY > snap.cur.y){
+            for(int i=0;i<4;i++){
+                for(int j=0;j<4;j++){
+                    if(pieceCell(snap.cur.type, snap.cur.rotation, i, j)){
+                        int bx = snap.cur.x + j;
+                        int by = snap.ghostY + i;
+                        if(by >= 0){
+                            DrawRectangleLines(boardX + bx*CELL, boardY + by*CELL, CELL-2, CELL-2,
+                                               Fade(PALETTE[snap.cur.type+1], 0.5f));
+                        }
+                    }
+                }
             }
         }
-    }
-
-    // Draw current piece
-    if(!game.gameOver){
         for(int i=0;i<4;i++){
             for(int j=0;j<4;j++){
-                if(game.pieceCell(game.cur.type, game.cur.rotation, i, j)){
-                    int bx = game.cur.x + j;
-                    int by = game.cur.y + i;
+                if(pieceCell(snap.cur.type, snap.cur.rotation, i, j)){
+                    int bx = snap.cur.x + j;
+                    int by = snap.cur.y + i;
                     if(by >= 0){
-                        DrawRectangle(boardX + bx*CELL, boardY + by*CELL, CELL-2, CELL-2, PALETTE[game.cur.type+1]);
+                        DrawRectangle(boardX + bx*CELL, boardY + by*CELL, CELL-2, CELL-2, PALETTE[snap.cur.type+1]);
                     }
                 }
             }
         }
     }
 
-    // Grid lines
-    for(int i=0;i<=BOARD_W;i++) DrawLine(boardX + i*CELL, boardY, boardX + i*CELL, boardY + BOARD_H*CELL, Fade(BLACK,0.12f));
-    for(int i=0;i<=BOARD_H;i++) DrawLine(boardX, boardY + i*CELL, boardX + BOARD_W*CELL, boardY + i*CELL, Fade(BLACK,0.12f));
-
-    // Sidebar info
+    // Sidebar info. The dynamic strings are re-formatted only when the
+    // underlying value changes, which for score/lines/level is a few
+    // times per second against 60fps of redraws.
     int sidebarX = boardX + BOARD_W*CELL + 20;
     int sidebarY = boardY;
-    
-    string modeStr = (game.mode == MANUAL) ? "MANUAL" : "AI";
-    DrawText(TextFormat("Mode: %s", modeStr.c_str()), sidebarX, sidebarY, 16, YELLOW);
-    DrawText(TextFormat("Score: %d", game.score), sidebarX, sidebarY + 28, 20, WHITE);
-    DrawText(TextFormat("Lines: %d", game.lines), sidebarX, sidebarY + 52, 18, WHITE);
-    DrawText(TextFormat("Level: %d", game.level), sidebarX, sidebarY + 76, 18, WHITE);
-
-    // Controls info
-    DrawText("Controls (Manual):", sidebarX, sidebarY + 130, 12, SKYBLUE);
-    DrawText("Arrows: Move/Drop", sidebarX, sidebarY + 150, 10, WHITE);
-    DrawText("Up/X: Rotate CW", sidebarX, sidebarY + 165, 10, WHITE);
-    DrawText("Z: Rotate CCW", sidebarX, sidebarY + 180, 10, WHITE);
-    DrawText("Space: Hard Drop", sidebarX, sidebarY + 195, 10, WHITE);
-    DrawText("P: Pause", sidebarX, sidebarY + 210, 10, WHITE);
-    DrawText("ESC: Menu", sidebarX, sidebarY + 225, 10, WHITE);
-
-    if(game.paused){
+
+    static char scoreStr[32], linesStr[32], levelStr[32];
+    static int lastScore = -1, lastLines = -1, lastLevel = -1;
+    if (snap.score != lastScore) { lastScore = snap.score; snprintf(scoreStr, sizeof scoreStr, "Score: %d", snap.score); }
+    if (snap.lines != lastLines) { lastLines = snap.lines; snprintf(linesStr, sizeof linesStr, "Lines: %d", snap.lines); }
+    if (snap.level != lastLevel) { lastLevel = snap.level; snprintf(levelStr, sizeof levelStr, "Level: %d", snap.level); }
+
+    DrawText((snap.mode == MANUAL) ? "Mode: MANUAL" : "Mode: AI", sidebarX, sidebarY, 16, YELLOW);
+    if(snap.mode != MANUAL){
+        if(snap.turboMul != 1)
+            DrawText(snap.turboMul == 0 ? "TURBO: MAX"
+                                        : TextFormat("TURBO: x%d", snap.turboMul),
+                     sidebarX + 110, sidebarY, 16, ORANGE);
+        DrawText("T: Turbo", sidebarX, WINDOW_H - 50, 12, LIGHTGRAY);
+    }
+    DrawText(scoreStr, sidebarX, sidebarY + 28, 20, WHITE);
+    DrawText(linesStr, sidebarX, sidebarY + 52, 18, WHITE);
+    DrawText(levelStr, sidebarX, sidebarY + 76, 18, WHITE);
+
+    DrawControlsCached(sidebarX, sidebarY + 130);
+
+    if(snap.paused){
         DrawRectangle(0, WINDOW_H/2 - 40, WINDOW_W, 80, Fade(BLACK, 0.5f));
-        DrawText("PAUSED", WINDOW_W/2 - MeasureText("PAUSED", 40)/2, WINDOW_H/2 - 20, 40, YELLOW);
+        DrawText("PAUSED", WINDOW_W/2 - MeasureLiteral("PAUSED", 40)/2, WINDOW_H/2 - 20, 40, YELLOW);
     }
 
-    if(game.gameOver){
+    if(snap.gameOver){
         DrawRectangle(0, WINDOW_H/2 - 80, WINDOW_W, 160, Fade(BLACK, 0.7f));
-        DrawText("GAME OVER", WINDOW_W/2 - MeasureText("GAME OVER", 50)/2, WINDOW_H/2 - 50, 50, RED);
-        DrawText(TextFormat("Score: %d  Lines: %d  Level: %d", game.score, game.lines, game.level), 
-                 WINDOW_W/2 - MeasureText("Score", 20)/2 - 80, WINDOW_H/2 + 20, 20, WHITE);
-        DrawText("ESC: Menu", WINDOW_W/2 - MeasureText("ESC: Menu", 16)/2, WINDOW_H/2 + 60, 16, LIGHTGRAY);
+        DrawText("GAME OVER", WINDOW_W/2 - MeasureLiteral("GAME OVER", 50)/2, WINDOW_H/2 - 50, 50, RED);
+        DrawText(TextFormat("Score: %d  Lines: %d  Level: %d", snap.score, snap.lines, snap.level), 
+                 WINDOW_W/2 - MeasureLiteral("Score", 20)/2 - 80, WINDOW_H/2 + 20, 20, WHITE);
+        DrawText("ESC: Menu", WINDOW_W/2 - MeasureLiteral("ESC: Menu", 16)/2, WINDOW_H/2 + 60, 16, LIGHTGRAY);
+    }
+}
+
+// ==================== INSTANCED CELL RENDERER ====================
+// The tournament tiles used to issue one DrawRectangle per settled cell,
+// which at mid-game fill is thousands of draw calls a frame for 64
+// boards. Instead every cell of every board becomes one instance of a
+// unit quad, batched by palette color: at most one DrawMeshInstanced
+// call per color (plus one per color for dimmed game-over boards), so
+// the whole grid is <=14 draw calls. Per-board instance arrays are
+// screen-space transforms cached against the board's version stamp and
+// rebuilt only when that board changed. The single-board view already
+// batches through its cached texture, so only the tiles use this path.
+//
+// raylib's default shader has no per-instance attributes, so a minimal
+// GLSL330 pair consumes the instanceTransform mat4 the same way the
+// upstream instancing example does. If the shader doesn't come up (GL
+// older than 3.3) the tiles fall back to the immediate-mode loop.
+
+static const char *CELL_INSTANCE_VS =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in mat4 instanceTransform;\n"
+    "uniform mat4 mvp;\n"
+    "void main() { gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0); }\n";
+
+static const char *CELL_INSTANCE_FS =
+    "#version 330\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main() { finalColor = colDiffuse; }\n";
+
+// Pixel-space transform for one cell: scale the unit quad to the cell
+// size and move it into place. In raylib's 2D mode the projection is
+// already the screen ortho, so no camera is involved.
+static Matrix cellTransform(float x, float y, float size) {
+    Matrix m{};
+    m.m0 = size; m.m5 = size; m.m10 = 1.0f; m.m15 = 1.0f;
+    m.m12 = x; m.m13 = y;
+    return m;
+}
+
+struct CellInstancer {
+    Mesh quad{};
+    Material mat{};
+    bool ready = false, tried = false;
+    // Frame batches by palette color; [8+c] is c dimmed for dead boards.
+    std::vector<Matrix> batch[16];
+
+    // First call builds the quad mesh and shader; returns whether the
+    // instanced path is usable at all.
+    bool init() {
+        if (tried) return ready;
+        tried = true;
+        Shader sh = LoadShaderFromMemory(CELL_INSTANCE_VS, CELL_INSTANCE_FS);
+        int instLoc = GetShaderLocationAttrib(sh, "instanceTransform");
+        if (sh.id == 0 || instLoc == -1) return false;
+        sh.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(sh, "mvp");
+        sh.locs[SHADER_LOC_MATRIX_MODEL] = instLoc;   // rlgl feeds instances here
+
+        static float verts[12] = {0,0,0, 1,0,0, 0,1,0, 1,1,0};
+        static unsigned short idx[6] = {0, 1, 2, 2, 1, 3};
+        quad.vertexCount = 4;
+        quad.triangleCount = 2;
+        quad.vertices = verts;
+        quad.indices = idx;
+        UploadMesh(&quad, false);
+
+        mat = LoadMaterialDefault();
+        mat.shader = sh;
+        ready = true;
+        return true;
+    }
+
+    void flush() {
+        // The screen ortho flips y, which flips winding; skip culling
+        // rather than carrying both windings in the mesh.
+        rlDisableBackfaceCulling();
+        for (int b = 0; b < 16; ++b) {
+            if (batch[b].empty()) continue;
+            Color c = PALETTE[b & 7];
+            if (b >= 8) c = Fade(c, 0.35f);
+            mat.maps[MATERIAL_MAP_DIFFUSE].color = c;
+            DrawMeshInstanced(quad, mat, batch[b].data(), (int)batch[b].size());
+            batch[b].clear();
+        }
+        rlEnableBackfaceCulling();
+    }
+};
+
+// Cached instance arrays for one tournament tile, keyed on the board
+// stamp plus the tile geometry (which only changes with the board count).
+struct TileCache {
+    unsigned version = 0;
+    int cellSize = 0, originX = -1, originY = -1;
+    std::vector<Matrix> perColor[8];
+};
+
+// Tiled tournament view: every board drawn small on the left, live
+// leaderboard on the right. Cells go through the instanced renderer
+// above; the snapshots make the reads race-free against the sim threads.
+void DrawTournamentScreen(TournamentSession& tour) {
+    ProfScope prof(PROF_DRAW);
+    ClearBackground(BLACK);
+
+    int n = (int)tour.entries.size();
+    int areaX = 10, areaY = 10;
+    int areaW = 440, areaH = WINDOW_H - 20;
+    int cols = 1;
+    while (cols * cols < n) cols++;
+    int rows = (n + cols - 1) / cols;
+    int tileW = areaW / cols, tileH = areaH / rows;
+    int cell = max(1, min((tileW - 4) / BOARD_W, (tileH - 4) / BOARD_H));
+
+    struct Rank { int idx, score, lines; bool alive; };
+    vector<Rank> ranks;
+    ranks.reserve(n);
+
+    static CellInstancer instancer;
+    static vector<TileCache> tiles;
+    bool instanced = instancer.init();
+    if ((int)tiles.size() != n) tiles.assign(n, TileCache{});
+
+    for (int i = 0; i < n; ++i) {
+        const RenderSnapshot& snap = tour.entries[i]->snapshots.read();
+        ranks.push_back({i, snap.score, snap.lines, !snap.gameOver});
+
+        int tx = areaX + (i % cols) * tileW;
+        int ty = areaY + (i / cols) * tileH;
+        Color border = snap.gameOver ? MAROON : DARKGRAY;
+        DrawRectangleLines(tx, ty, BOARD_W*cell + 2, BOARD_H*cell + 2, border);
+
+        if (!instanced) {
+            for (int r = 0; r < BOARD_H; ++r)
+                for (int c = 0; c < BOARD_W; ++c) {
+                    int v = snap.board.cells[r][c];
+                    if (v) DrawRectangle(tx + 1 + c*cell, ty + 1 + r*cell, cell, cell,
+                                         snap.gameOver ? Fade(PALETTE[v], 0.35f) : PALETTE[v]);
+                }
+            continue;
+        }
+
+        // Rebuild this tile's instance arrays only when its board (or,
+        // once per session, the tile geometry) changed. Dimming for dead
+        // boards happens at batch level, so game over alone is no rebuild.
+        TileCache &tc = tiles[i];
+        if (tc.version != snap.boardVersion || tc.cellSize != cell ||
+            tc.originX != tx + 1 || tc.originY != ty + 1) {
+            tc.version = snap.boardVersion;
+            tc.cellSize = cell;
+            tc.originX = tx + 1;
+            tc.originY = ty + 1;
+            for (auto &v : tc.perColor) v.clear();
+            for (int r = 0; r < BOARD_H; ++r)
+                for (int c = 0; c < BOARD_W; ++c) {
+                    int v = snap.board.cells[r][c];
+                    if (v) tc.perColor[v].push_back(
+                        cellTransform((float)(tx + 1 + c*cell), (float)(ty + 1 + r*cell), (float)cell));
+                }
+        }
+        int dim = snap.gameOver ? 8 : 0;
+        for (int v = 1; v < 8; ++v)
+            instancer.batch[v + dim].insert(instancer.batch[v + dim].end(),
+                                            tc.perColor[v].begin(), tc.perColor[v].end());
+    }
+    if (instanced) instancer.flush();
+
+    sort(ranks.begin(), ranks.end(),
+         [](const Rank& a, const Rank& b) { return a.score > b.score; });
+    int alive = 0;
+    for (const Rank& r : ranks) alive += r.alive;
+
+    int lbX = areaX + areaW + 20, lbY = 20;
+    DrawText("TOURNAMENT", lbX, lbY, 22, SKYBLUE);
+    DrawText(TextFormat("%d boards, %d alive", n, alive), lbX, lbY + 30, 14, LIGHTGRAY);
+    DrawText(TextFormat("%d sim threads", (int)tour.threads.size()), lbX, lbY + 48, 14, LIGHTGRAY);
+    for (int i = 0; i < min(n, 14); ++i) {
+        const Rank& r = ranks[i];
+        DrawText(TextFormat("%2d. #%02d  %6d  %4d ln%s", i + 1, r.idx + 1, r.score,
+                            r.lines, r.alive ? "" : "  X"),
+                 lbX, lbY + 80 + i * 22, 14, r.alive ? WHITE : GRAY);
+    }
+    DrawText("ESC: Menu", lbX, WINDOW_H - 30, 14, LIGHTGRAY);
+}
+
+// ==================== FRAME PACING ====================
+// SetTargetFPS makes raylib busy-wait out the remainder of every frame,
+// which burns a full core even sitting in a menu. FramePacer instead
+// sleeps the frame gap and spins only the last couple of milliseconds
+// before the deadline (OS sleep granularity makes a pure sleep overshoot),
+// and drops to IDLE_FPS when nothing on screen needs 60Hz: menus, pause
+// and game-over screens with no recent input. Any key press counts as
+// activity and restores the full rate for ACTIVE_HOLD seconds; the one
+// idle-length frame in flight when the key lands is the only extra
+// latency. Running games always get the full rate.
+const int ACTIVE_FPS = 60;
+const int IDLE_FPS = 10;
+const double ACTIVE_HOLD = 1.5;     // seconds of full rate after input
+const double SPIN_MARGIN = 0.002;   // sleep until this close, then spin
+
+struct FramePacer {
+    double nextDeadline = 0.0;
+
+    // Call once per frame after EndDrawing.
+    void pace(bool idle) {
+        const double period = 1.0 / (idle ? IDLE_FPS : ACTIVE_FPS);
+        double now = GetTime();
+        // Catch up after a stall, and pull the deadline in when leaving
+        // idle so the first active frame isn't paced at the idle period.
+        if (nextDeadline < now) nextDeadline = now;
+        if (nextDeadline > now + period) nextDeadline = now + period;
+        double sleepUntil = nextDeadline - SPIN_MARGIN;
+        if (sleepUntil > now)
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(sleepUntil - now));
+        while (GetTime() < nextDeadline) { /* late spin */ }
+        nextDeadline += period;
+    }
+};
+
+// Timing overlay (F1): p50/p99 per instrumented phase over each ring's
+// last 2048 samples. Percentile extraction only runs while visible.
+void DrawProfOverlay() {
+    int x = WINDOW_W - 250, y = WINDOW_H - 30 - (PROF_PHASES + 1) * 18;
+    DrawRectangle(x - 10, y - 10, 250, (PROF_PHASES + 1) * 18 + 20, Fade(BLACK, 0.7f));
+    DrawText("phase            p50       p99", x, y, 12, YELLOW);
+    for (int p = 0; p < PROF_PHASES; ++p) {
+        double p50 = profPercentileNs((ProfPhase)p, 50.0) / 1000.0;
+        double p99 = profPercentileNs((ProfPhase)p, 99.0) / 1000.0;
+        DrawText(TextFormat("%-13s %7.1f %9.1f us", PROF_NAMES[p], p50, p99),
+                 x, y + 18 * (p + 1), 12, WHITE);
     }
 }
 
 // ==================== MAIN ====================
-int main(){
+int main(int argc, char **argv){
+    // --prof-csv FILE: dump the instrumentation rings on exit.
+    // --seed S: reproducible piece sequences; every session started from
+    //           the menus uses S (tournament game i plays S+i).
+    // --save FILE: snapshot the running game to FILE periodically and on
+    //              exit (see SNAPSHOT SAVE / RESUME above).
+    // --resume FILE: restore FILE at startup and go straight to PLAYING,
+    //                skipping both menus; cold start is then bounded by
+    //                InitWindow alone. Implies --save FILE unless a
+    //                separate --save path is given.
+    const char *profCsvPath = nullptr;
+    uint64_t cliSeed = 0;
+    bool haveSeed = false;
+    const char *savePath = nullptr;
+    const char *resumePath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--prof-csv") == 0 && i + 1 < argc) {
+            profCsvPath = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            cliSeed = strtoull(argv[++i], nullptr, 10);
+            haveSeed = true;
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+            resumePath = argv[++i];
+        }
+    }
+    if (resumePath && !savePath) savePath = resumePath;
+    profTicksPerNs();   // plant the tsc calibration anchor early
+
     InitWindow(WINDOW_W, WINDOW_H, "Tetris - Manual & AI Modes");
-    SetTargetFPS(60);
+    // No SetTargetFPS: FramePacer does the frame limiting without the
+    // busy-wait (and with the idle drop), see above.
+    FramePacer pacer;
+    double lastInputTime = 0.0;
+    bool profOverlay = false;
 
     GameState gameState = MAIN_MENU;
     GameMode selectedMode = MANUAL;
+    int aiPreset = 0;
     int selectedMenuOption = 0;
     bool showInstructions = false;
     float animTime = 0.0f;
 
-    Game* game = nullptr;
+    SimSession* sim = nullptr;
+    TournamentSession* tour = nullptr;
+
+    // Resume path: restore the saved game and land directly in PLAYING.
+    // A missing or corrupt file falls through to the normal menu flow;
+    // tournaments are never saved so no TOURNAMENT mode arrives here.
+    if (resumePath) {
+        GameSave s;
+        if (readSave(resumePath, s) && s.mode != TOURNAMENT) {
+            selectedMode = (GameMode)s.mode;
+            aiPreset = s.aiPreset;
+            sim = new SimSession(selectedMode, AI_PRESETS[aiPreset],
+                                 0, false, aiPreset, savePath, &s);
+            gameState = PLAYING;
+        }
+    }
 
     while(!WindowShouldClose()){
         float dt = GetFrameTime();
         animTime += dt;
-        
+        if(IsKeyPressed(KEY_F1)) profOverlay = !profOverlay;
+
+        // Activity tracking for the idle frame-rate drop. GetKeyPressed
+        // drains raylib's key-press queue, which nothing else here reads;
+        // IsKeyPressed works off the state arrays and is unaffected.
+        while (GetKeyPressed() != 0) lastInputTime = GetTime();
+        bool recentInput = GetTime() - lastInputTime < ACTIVE_HOLD;
+
         // MAIN MENU
         if(gameState == MAIN_MENU) {
             if(!showInstructions) {
@@ -737,20 +1563,33 @@ int main(){
                 DrawMainMenu(selectedMenuOption, animTime);
             }
             EndDrawing();
+            pacer.pace(!recentInput);
             continue;
         }
         
         // MODE SELECTION
         if(gameState == MODE_SELECT) {
             if(IsKeyPressed(KEY_UP)) {
-                selectedMode = (selectedMode == MANUAL) ? AI : MANUAL;
+                selectedMode = (GameMode)((selectedMode + 2) % 3);
             }
             if(IsKeyPressed(KEY_DOWN)) {
-                selectedMode = (selectedMode == MANUAL) ? AI : MANUAL;
+                selectedMode = (GameMode)((selectedMode + 1) % 3);
+            }
+            if(selectedMode == AI) {
+                if(IsKeyPressed(KEY_LEFT))
+                    aiPreset = (aiPreset + AI_PRESET_COUNT - 1) % AI_PRESET_COUNT;
+                if(IsKeyPressed(KEY_RIGHT))
+                    aiPreset = (aiPreset + 1) % AI_PRESET_COUNT;
             }
             if(IsKeyPressed(KEY_ENTER)) {
-                if(game) delete game;
-                game = new Game(selectedMode);
+                if(sim) { delete sim; sim = nullptr; }
+                if(tour) { delete tour; tour = nullptr; }
+                if(selectedMode == TOURNAMENT) {
+                    tour = new TournamentSession(TOURNEY_GAMES, cliSeed, haveSeed);
+                } else {
+                    sim = new SimSession(selectedMode, AI_PRESETS[aiPreset],
+                                         cliSeed, haveSeed, aiPreset, savePath);
+                }
                 gameState = PLAYING;
             }
             if(IsKeyPressed(KEY_ESCAPE)) {
@@ -759,39 +1598,71 @@ int main(){
             }
             
             BeginDrawing();
-            DrawModeSelect((int&)selectedMode);
+            DrawModeSelect((int&)selectedMode, aiPreset);
             EndDrawing();
+            pacer.pace(!recentInput);
             continue;
         }
         
-        // PLAYING
-        if(gameState == PLAYING && game) {
-            if(IsKeyPressed(KEY_P) && game->mode == MANUAL) {
-                game->paused = !game->paused;
+        // PLAYING (tournament)
+        if(gameState == PLAYING && tour) {
+            if(IsKeyPressed(KEY_ESCAPE)) {
+                gameState = MAIN_MENU;
+                selectedMenuOption = 0;
+                delete tour;   // joins the shard threads
+                tour = nullptr;
+                continue;
             }
-            
-            if(game->gameOver) {
-                if(IsKeyPressed(KEY_ESCAPE)) {
-                    gameState = MAIN_MENU;
-                    selectedMenuOption = 0;
-                    delete game;
-                    game = nullptr;
-                }
+            BeginDrawing();
+            DrawTournamentScreen(*tour);
+            if(profOverlay) DrawProfOverlay();
+            EndDrawing();
+            pacer.pace(false);   // boards animate continuously
+            continue;
+        }
+
+        // PLAYING
+        if(gameState == PLAYING && sim) {
+            // Gameplay keys are watched by the session's 1kHz sampler
+            // thread; this loop only pumps events (EndDrawing) and keeps
+            // the meta keys (ESC, F1, T) frame-polled.
+            const RenderSnapshot& snap = sim->snapshots.read();
+
+            // T cycles the AI fast-forward speed (x1 -> x10 -> x100 -> MAX).
+            if(snap.mode != MANUAL && IsKeyPressed(KEY_T)) {
+                int cur = sim->turbo.load(std::memory_order_relaxed);
+                int idx = 0;
+                while (idx < TURBO_SPEED_COUNT && TURBO_SPEEDS[idx] != cur) idx++;
+                sim->turbo.store(TURBO_SPEEDS[(idx + 1) % TURBO_SPEED_COUNT],
+                                 std::memory_order_relaxed);
             }
-            
-            if(game->mode == MANUAL) {
-                game->updateManual(dt);
-            } else {
-                game->updateAI(dt);
+
+            if(snap.gameOver && IsKeyPressed(KEY_ESCAPE)) {
+                gameState = MAIN_MENU;
+                selectedMenuOption = 0;
+                delete sim;   // joins the sim thread
+                sim = nullptr;
+                continue;
             }
-            
+
             BeginDrawing();
-            DrawGameScreen(*game);
+            DrawGameScreen(snap);
+            if(profOverlay) DrawProfOverlay();
             EndDrawing();
+            // Pause and game-over are static screens; a running game
+            // needs the full rate.
+            pacer.pace((snap.paused || snap.gameOver) && !recentInput);
         }
     }
 
-    if(game) delete game;
+    if(sim) delete sim;
+    if(tour) delete tour;
+    if(profCsvPath) {
+        if(profDumpCsv(profCsvPath))
+            cout << "profile rings dumped to " << profCsvPath << endl;
+        else
+            cerr << "failed to write " << profCsvPath << endl;
+    }
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,122 @@
+// tetris_prof.h
+// Always-on hot-path instrumentation. A ProfScope stamps rdtsc on entry
+// and drops the elapsed ticks into a fixed-size per-phase ring buffer on
+// exit: no allocation, no locking, a handful of nanoseconds per scope,
+// so it stays enabled in release builds. Multiple threads record into
+// the same ring through relaxed atomics; a torn percentile under heavy
+// contention is acceptable for a diagnostic.
+//
+// Aggregation (percentiles, CSV export) copies the rings and is only
+// paid when the overlay is visible or the dump flag is set.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+enum ProfPhase {
+    PROF_SEARCH,         // findBestMove / findBestMoveLookahead
+    PROF_CLEAR,          // Board::clearLines
+    PROF_UPDATE_AI,      // Game::updateAI
+    PROF_UPDATE_MANUAL,  // Game::updateManual
+    PROF_DRAW,           // DrawGameScreen / DrawTournamentScreen
+    PROF_INPUT,          // key press to sim apply (recorded, not a scope)
+    PROF_PHASES
+};
+
+inline const char *const PROF_NAMES[PROF_PHASES] = {
+    "search", "clear_lines", "update_ai", "update_manual", "draw",
+    "input_latency"
+};
+
+inline uint64_t profTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+// TSC ticks per nanosecond, measured against steady_clock from the
+// first call. Call once early (main) to plant the anchor; by the time
+// anything is displayed the baseline spans long enough to be accurate.
+inline double profTicksPerNs() {
+    struct Anchor {
+        uint64_t tsc;
+        std::chrono::steady_clock::time_point tp;
+    };
+    static const Anchor a{profTicks(), std::chrono::steady_clock::now()};
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - a.tp).count();
+    if (ns < 1000000) return 1.0;   // anchor too fresh to divide by
+    return (double)(profTicks() - a.tsc) / (double)ns;
+}
+
+struct ProfRing {
+    static const unsigned SIZE = 2048;
+    std::array<std::atomic<uint64_t>, SIZE> samples{};
+    std::atomic<unsigned> head{0};
+
+    void record(uint64_t ticks) {
+        unsigned i = head.fetch_add(1, std::memory_order_relaxed);
+        samples[i % SIZE].store(ticks, std::memory_order_relaxed);
+    }
+};
+
+inline std::array<ProfRing, PROF_PHASES> &profRings() {
+    static std::array<ProfRing, PROF_PHASES> rings;
+    return rings;
+}
+
+struct ProfScope {
+    ProfPhase phase;
+    uint64_t t0;
+    explicit ProfScope(ProfPhase p) : phase(p), t0(profTicks()) {}
+    ~ProfScope() { profRings()[phase].record(profTicks() - t0); }
+};
+
+inline unsigned long long profCount(ProfPhase p) {
+    return profRings()[p].head.load(std::memory_order_relaxed);
+}
+
+// Percentile in nanoseconds over the ring's current contents (the last
+// SIZE samples); 0 when the phase never ran.
+inline double profPercentileNs(ProfPhase p, double pct) {
+    const ProfRing &ring = profRings()[p];
+    unsigned n = std::min(ring.head.load(std::memory_order_relaxed), ProfRing::SIZE);
+    if (n == 0) return 0.0;
+    std::vector<uint64_t> v(n);
+    for (unsigned i = 0; i < n; ++i)
+        v[i] = ring.samples[i].load(std::memory_order_relaxed);
+    unsigned k = (unsigned)(pct / 100.0 * (n - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return (double)v[k] / profTicksPerNs();
+}
+
+// One row per retained sample: phase name, ring slot, ticks, ns.
+inline bool profDumpCsv(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    double tpn = profTicksPerNs();
+    fprintf(f, "phase,slot,ticks,ns\n");
+    for (int p = 0; p < PROF_PHASES; ++p) {
+        const ProfRing &ring = profRings()[(ProfPhase)p];
+        unsigned n = std::min(ring.head.load(std::memory_order_relaxed), ProfRing::SIZE);
+        for (unsigned i = 0; i < n; ++i) {
+            uint64_t t = ring.samples[i].load(std::memory_order_relaxed);
+            fprintf(f, "%s,%u,%llu,%.0f\n", PROF_NAMES[p], i,
+                    (unsigned long long)t, (double)t / tpn);
+        }
+    }
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,132 @@
+// tetris_replay.h
+// Compact binary replay format for AI games. A game is fully determined
+// by the bag seed plus (pieceType, rotationIndex, leftC) per move, so a
+// replay is a 16-byte header followed by 3 bytes per move: a
+// million-move game is ~3MB. Playback memory-maps the file and
+// re-simulates on the bitboard, so seeking to any move index is a
+// re-simulation of at most the whole game at headless speed
+// (milliseconds), not a re-run of the search.
+//
+// Used by the headless tools; POSIX (mmap) only.
+
+#pragma once
+
+#include "tetris_core.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct ReplayHeader {
+    char magic[4];      // "TREP"
+    uint32_t version;   // 1
+    uint64_t seed;      // bag RNG seed
+};
+
+// ReplayMove itself lives in tetris_core.h so playHeadless can record
+// without pulling in file I/O.
+static_assert(sizeof(ReplayMove) == 3, "replay moves are packed");
+
+inline bool writeReplay(const char *path, uint64_t seed,
+                        const std::vector<ReplayMove> &moves) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    ReplayHeader h{};
+    memcpy(h.magic, "TREP", 4);
+    h.version = 1;
+    h.seed = seed;
+    bool ok = fwrite(&h, sizeof h, 1, f) == 1;
+    if (ok && !moves.empty())
+        ok = fwrite(moves.data(), sizeof(ReplayMove), moves.size(), f) == moves.size();
+    fclose(f);
+    return ok;
+}
+
+// Memory-mapped replay; moves are read straight out of the page cache.
+class ReplayFile {
+public:
+    ReplayFile() = default;
+    ~ReplayFile() { close(); }
+    ReplayFile(const ReplayFile &) = delete;
+    ReplayFile &operator=(const ReplayFile &) = delete;
+
+    bool open(const char *path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ReplayHeader)) {
+            ::close(fd);
+            return false;
+        }
+        mapSize = (size_t)st.st_size;
+        map = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) { map = nullptr; return false; }
+        const ReplayHeader *h = (const ReplayHeader *)map;
+        if (memcmp(h->magic, "TREP", 4) != 0 || h->version != 1) {
+            close();
+            return false;
+        }
+        seed = h->seed;
+        moves = (const ReplayMove *)((const char *)map + sizeof(ReplayHeader));
+        count = (mapSize - sizeof(ReplayHeader)) / sizeof(ReplayMove);
+        return true;
+    }
+
+    void close() {
+        if (map) munmap(map, mapSize);
+        map = nullptr;
+        moves = nullptr;
+        count = 0;
+    }
+
+    uint64_t seed = 0;
+    const ReplayMove *moves = nullptr;
+    size_t count = 0;
+
+private:
+    void *map = nullptr;
+    size_t mapSize = 0;
+};
+
+// Reconstruct the board as it was after `upTo` moves (clamped to the
+// replay length) into `bb`. Stats accumulate the same scoring
+// playHeadless uses. The records come straight off the mapped file, and
+// a well-formed header does not make the payload sane: each one is
+// range-checked before it indexes the piece tables or the board, and a
+// bad record fails the whole replay (false), like a bad header fails
+// open(). bb and stats then hold the state up to the corrupt record.
+inline bool replayToMove(const ReplayFile &rf, size_t upTo, BitBoard &bb,
+                         HeadlessStats *stats = nullptr) {
+    bb = BitBoard();
+    HeadlessStats st;
+    bool ok = true;
+    if (upTo > rf.count) upTo = rf.count;
+    for (size_t i = 0; i < upTo; ++i) {
+        const ReplayMove &m = rf.moves[i];
+        if (m.type >= 7 || (int)m.rotation >= PIECE_ROTATIONS[m.type]) {
+            ok = false;
+            break;
+        }
+        const PieceMasks &pm = PIECE_TABLE[m.type][m.rotation];
+        if (m.leftC < -pm.minCol || m.leftC + pm.maxCol >= BOARD_W) {
+            ok = false;
+            break;
+        }
+        int top = bb.dropRow(pm, m.leftC);
+        bb.place(pm, top, m.leftC);
+        int cleared = bb.clearLines();
+        st.pieces++;
+        if (cleared > 0) {
+            st.lines += cleared;
+            st.score += 100 * (1 << (cleared - 1));
+        }
+    }
+    if (stats) *stats = st;
+    return ok;
+}
@@ -0,0 +1,124 @@
+// tuner.cpp
+// Evolutionary tuner for the heuristic weights. A (mu+lambda) evolution
+// strategy: each generation evaluates a population of weight vectors by
+// playing a batch of seeded headless games per candidate, keeps the
+// best quarter as parents and refills the population with Gaussian
+// mutations whose step size decays over generations. All candidates in
+// a generation play the same seeds so fitness differences come from the
+// weights, not the piece sequence. Candidate-game pairs are distributed
+// across the shared thread pool.
+//
+// Build: make tuner
+// Usage: ./tuner [--generations N] [--population N] [--games N]
+//                [--max-pieces N] [--seed S]
+
+#include "tetris_core.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+struct Candidate {
+    Weights w;
+    double fitness = 0.0;
+};
+
+// Fitness of one candidate: mean lines over the generation's seeds.
+// Games are capped so degenerate-but-immortal weight vectors cannot
+// stall a generation.
+static double evaluate(const Weights &w, const std::vector<uint64_t> &seeds,
+                       long long maxPieces, ThreadPool &pool) {
+    std::vector<long long> lines(seeds.size(), 0);
+    pool.run((int)seeds.size(), [&](int i) {
+        Bag bag(seeds[i]);
+        HeadlessStats st = playHeadless(bag, maxPieces, false, nullptr, w);
+        lines[i] = st.lines;
+    });
+    long long total = 0;
+    for (long long l : lines) total += l;
+    return (double)total / seeds.size();
+}
+
+int main(int argc, char **argv) {
+    int generations = 20;
+    int population = 100;
+    int games = 10;
+    long long maxPieces = 5000;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--generations") && i+1 < argc) generations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--population") && i+1 < argc) population = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--games") && i+1 < argc) games = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--max-pieces") && i+1 < argc) maxPieces = atoll(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i+1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else {
+            fprintf(stderr, "usage: %s [--generations N] [--population N] [--games N]"
+                            " [--max-pieces N] [--seed S]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (population < 8) population = 8;
+    int parents = population / 4;
+
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> gauss(0.0, 1.0);
+    std::uniform_real_distribution<double> uni(-1.0, 1.0);
+
+    ThreadPool &pool = aiThreadPool();
+    printf("tuner: pop=%d games=%d max-pieces=%lld threads=%d\n",
+           population, games, maxPieces, pool.size());
+
+    // Seed the population around the shipped weights plus random vectors.
+    std::vector<Candidate> pop(population);
+    pop[0].w = Weights{};
+    for (int i = 1; i < population; ++i) {
+        pop[i].w.lines = uni(rng);
+        pop[i].w.hole = -std::abs(uni(rng));
+        pop[i].w.height = -std::abs(uni(rng));
+        pop[i].w.bumpy = -std::abs(uni(rng));
+    }
+
+    for (int gen = 0; gen < generations; ++gen) {
+        // Fresh seeds each generation so weights cannot overfit one
+        // particular piece sequence; shared within the generation so the
+        // comparison is fair.
+        std::vector<uint64_t> seeds(games);
+        for (auto &s : seeds) s = rng();
+
+        double mean = 0.0;
+        for (auto &c : pop) {
+            c.fitness = evaluate(c.w, seeds, maxPieces, pool);
+            mean += c.fitness;
+        }
+        mean /= population;
+
+        std::sort(pop.begin(), pop.end(),
+                  [](const Candidate &a, const Candidate &b) { return a.fitness > b.fitness; });
+
+        const Candidate &best = pop[0];
+        printf("gen %2d: best=%.1f mean=%.1f  w={%.4f, %.4f, %.4f, %.4f}\n",
+               gen, best.fitness, mean,
+               best.w.lines, best.w.hole, best.w.height, best.w.bumpy);
+        fflush(stdout);
+
+        // Refill from the parents with decaying mutation strength.
+        double sigma = 0.3 * std::pow(0.9, gen);
+        for (int i = parents; i < population; ++i) {
+            const Candidate &p = pop[rng() % parents];
+            pop[i].w = p.w;
+            pop[i].w.lines += sigma * gauss(rng);
+            pop[i].w.hole += sigma * gauss(rng);
+            pop[i].w.height += sigma * gauss(rng);
+            pop[i].w.bumpy += sigma * gauss(rng);
+        }
+    }
+
+    printf("final: w={%.6f, %.6f, %.6f, %.6f}\n",
+           pop[0].w.lines, pop[0].w.hole, pop[0].w.height, pop[0].w.bumpy);
+    printf("paste into tetris_core.h: W_LINES/W_HOLE/W_HEIGHT/W_BUMPY\n");
+    return 0;
+}